@@ -27,6 +27,15 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <condition_variable>
+
+#if !PEN_PLATFORM_WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 constexpr bool k_force_login = false;
 constexpr bool k_force_no_discogs_login = false;
@@ -36,6 +45,13 @@ constexpr bool k_disable_waveform = false;
 constexpr u32 k_max_texture_creates_per_frame = 1;
 
 constexpr u32 k_waveform_resolution = 128;
+constexpr u32 k_discogs_detail_workers = 4;
+constexpr u32 k_feed_page_size = 100;
+constexpr s32 k_feed_page_ahead = 50;
+constexpr bool k_delta_registry_sync = true;
+constexpr f64 k_delta_sync_round_s = 30.0;
+constexpr f64 k_delta_full_sync_s = 7.0 * 24.0 * 60.0 * 60.0;
+constexpr size_t k_populate_batch_size = 64;
 
 using namespace put;
 using namespace pen;
@@ -115,17 +131,330 @@ void pop_font_scale()
 namespace curl
 {
     constexpr size_t k_min_alloc = 1024;
+    constexpr size_t k_max_pooled_handles = 16;
+    constexpr u32    k_max_concurrent_transfers = 6;
+    constexpr u32    k_max_batch_streams = 32;
+
+    constexpr const c8* k_browser_user_agent = "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/117.0.0.0 Safari/537.36";
 
+    constexpr size_t k_max_pooled_buffers = 8;
+    constexpr size_t k_max_pooled_buffer_size = 16 * 1024 * 1024;
+
+    // response body. memory comes from the buffer pool and must be returned with release_buffer
     struct DataBuffer {
         u8*         data = nullptr;
         size_t      size = 0;
         size_t      alloc_size = 0;
         CURLcode    code = CURLE_OK;
+        CURL*       handle = nullptr; // when set the first write pre-sizes from Content-Length
+    };
+
+    // recycled body allocations shared by all loader threads and the engine
+    struct BufferPool {
+        struct Block {
+            u8*     data;
+            size_t  alloc_size;
+        };
+
+        std::mutex          mutex;
+        std::vector<Block>  blocks;
+    };
+    BufferPool s_buffer_pool;
+
+    // grows db to hold at least size bytes, taking the smallest pooled block that fits when db is empty
+    void reserve_buffer(DataBuffer* db, size_t size)
+    {
+        if(size <= db->alloc_size) {
+            return;
+        }
+
+        if(!db->data)
+        {
+            s_buffer_pool.mutex.lock();
+            size_t best = s_buffer_pool.blocks.size();
+            for(size_t i = 0; i < s_buffer_pool.blocks.size(); ++i) {
+                auto& b = s_buffer_pool.blocks[i];
+                if(b.alloc_size >= size && (best == s_buffer_pool.blocks.size() || b.alloc_size < s_buffer_pool.blocks[best].alloc_size)) {
+                    best = i;
+                }
+            }
+
+            if(best < s_buffer_pool.blocks.size()) {
+                db->data = s_buffer_pool.blocks[best].data;
+                db->alloc_size = s_buffer_pool.blocks[best].alloc_size;
+                s_buffer_pool.blocks.erase(s_buffer_pool.blocks.begin() + best);
+            }
+            s_buffer_pool.mutex.unlock();
+
+            if(db->data) {
+                return;
+            }
+        }
+
+        db->data = (u8*)realloc(db->data, size);
+        db->alloc_size = size;
+        PEN_ASSERT(db->data);
+    }
+
+    // returns the body memory to the pool, oversized blocks or a full pool free it instead
+    void release_buffer(DataBuffer& db)
+    {
+        if(db.data)
+        {
+            bool pooled = false;
+            if(db.alloc_size <= k_max_pooled_buffer_size)
+            {
+                s_buffer_pool.mutex.lock();
+                if(s_buffer_pool.blocks.size() < k_max_pooled_buffers) {
+                    s_buffer_pool.blocks.push_back({db.data, db.alloc_size});
+                    pooled = true;
+                }
+                s_buffer_pool.mutex.unlock();
+            }
+
+            if(!pooled) {
+                free(db.data);
+            }
+        }
+
+        db.data = nullptr;
+        db.size = 0;
+        db.alloc_size = 0;
+    }
+
+    // persistent client shared by all requests. easy handles are recycled through a pool and
+    // every handle is attached to the same share object, so dns lookups and tls sessions are reused
+    // across requests to the same firebase / cdn hosts. connections are not shared, libcurl doesn't
+    // support a shared connection cache used from several threads at once. a pooled handle keeps its
+    // own connections alive across curl_easy_reset and the engine's multi handle keeps its own
+    struct Client {
+        CURLSH*             share = nullptr;
+        std::mutex          share_locks[CURL_LOCK_DATA_LAST];
+        std::mutex          pool_mutex;
+        std::vector<CURL*>  pool;
+    };
+    Client s_client;
+
+    void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+    {
+        s_client.share_locks[data].lock();
+    }
+
+    void share_unlock(CURL* handle, curl_lock_data data, void* userptr)
+    {
+        s_client.share_locks[data].unlock();
+    }
+
+    // body bytes received on the wire vs bytes after content decoding, for the json entry points
+    struct TransferStats {
+        std::atomic<u64> requests = { 0 };
+        std::atomic<u64> wire_bytes = { 0 };
+        std::atomic<u64> decoded_bytes = { 0 };
+    };
+    TransferStats s_stats;
+
+    // asks for gzip / deflate / brotli, whichever this libcurl build can decode. responses are decoded transparently
+    void enable_compression(CURL* curl)
+    {
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    }
+
+    void record_transfer_bytes(CURL* curl, const DataBuffer& db)
+    {
+        curl_off_t wire = 0;
+        curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &wire);
+
+        s_stats.requests++;
+        s_stats.wire_bytes += (u64)wire;
+        s_stats.decoded_bytes += db.size;
+    }
+
+    // per transfer timings, recorded into a ring per category. it's only read by the debug ui, so a mutex
+    // per ring keeps it simple
+    constexpr size_t k_telemetry_ring_size = 256;
+
+    struct TransferRecord {
+        f32                 dns_ms = 0.0f;
+        f32                 connect_ms = 0.0f;
+        f32                 tls_ms = 0.0f;
+        f32                 ttfb_ms = 0.0f;
+        f32                 total_ms = 0.0f;
+        u64                 bytes = 0;
+        s32                 http_code = 0;
+        TransferCategory_t  category = TransferCategory::registry;
+    };
+
+    struct TelemetryRing {
+        std::mutex          mutex;
+        TransferRecord      records[k_telemetry_ring_size];
+        u64                 head = 0;
+    };
+    TelemetryRing s_telemetry[TransferCategory::count];
+
+    const c8* k_transfer_category_names[] = {
+        "registry",
+        "artwork",
+        "audio",
+        "discogs",
+        "user data"
     };
+    static_assert(PEN_ARRAY_SIZE(k_transfer_category_names) == TransferCategory::count, "mismatched category names");
+
+    void record_telemetry(CURL* curl, TransferCategory_t category)
+    {
+        curl_off_t dns = 0, connect = 0, tls = 0, ttfb = 0, total = 0, bytes = 0;
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+        curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tls);
+        curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &ttfb);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+        curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+        // curl times are cumulative from the start of the transfer in microseconds, split them into phases.
+        // reused connections report 0 for the phases they skipped
+        TransferRecord r;
+        r.dns_ms = (f32)dns / 1000.0f;
+        r.connect_ms = connect > 0 ? (f32)(connect - dns) / 1000.0f : 0.0f;
+        r.tls_ms = tls > 0 ? (f32)(tls - connect) / 1000.0f : 0.0f;
+        r.ttfb_ms = (f32)ttfb / 1000.0f;
+        r.total_ms = (f32)total / 1000.0f;
+        r.bytes = (u64)bytes;
+        r.http_code = (s32)http_code;
+        r.category = category;
+
+        auto& ring = s_telemetry[category];
+        std::lock_guard<std::mutex> lock(ring.mutex);
+        ring.records[ring.head % k_telemetry_ring_size] = r;
+        ring.head++;
+    }
+
+    // copies the records of a category into out
+    void telemetry_snapshot(TransferCategory_t category, std::vector<TransferRecord>& out)
+    {
+        out.clear();
+        auto& ring = s_telemetry[category];
+        std::lock_guard<std::mutex> lock(ring.mutex);
+        u64 count = std::min<u64>(ring.head, k_telemetry_ring_size);
+        for(u64 n = ring.head - count; n < ring.head; ++n) {
+            out.push_back(ring.records[n % k_telemetry_ring_size]);
+        }
+    }
+
+    // p50, p95, p99 of a record field
+    void telemetry_percentiles(const std::vector<TransferRecord>& records, f32 TransferRecord::* field, f32 out[3])
+    {
+        out[0] = out[1] = out[2] = 0.0f;
+        if(records.empty()) {
+            return;
+        }
+
+        std::vector<f32> values;
+        values.reserve(records.size());
+        for(auto& r : records) {
+            values.push_back(r.*field);
+        }
+        std::sort(values.begin(), values.end());
+
+        const f32 pct[3] = { 0.50f, 0.95f, 0.99f };
+        for(u32 i = 0; i < 3; ++i) {
+            size_t index = std::min(values.size() - 1, (size_t)(pct[i] * (f32)values.size()));
+            out[i] = values[index];
+        }
+    }
+
+    // writes every settled record to a json file
+    bool dump_telemetry(const c8* filepath)
+    {
+        nlohmann::json dump = nlohmann::json::object();
+        std::vector<TransferRecord> records;
+        for(u32 c = 0; c < TransferCategory::count; ++c)
+        {
+            telemetry_snapshot(c, records);
+            auto& out = dump[k_transfer_category_names[c]];
+            out = nlohmann::json::array();
+            for(auto& r : records) {
+                out.push_back({
+                    {"dns_ms", r.dns_ms},
+                    {"connect_ms", r.connect_ms},
+                    {"tls_ms", r.tls_ms},
+                    {"ttfb_ms", r.ttfb_ms},
+                    {"total_ms", r.total_ms},
+                    {"bytes", r.bytes},
+                    {"http_code", r.http_code}
+                });
+            }
+        }
+
+        std::ofstream file(filepath);
+        if(!file) {
+            return false;
+        }
+
+        file << dump.dump(4);
+        return true;
+    }
+
+    void start_engine();
 
     void init()
     {
         curl_global_init(CURL_GLOBAL_ALL);
+
+        s_client.share = curl_share_init();
+        curl_share_setopt(s_client.share, CURLSHOPT_LOCKFUNC, share_lock);
+        curl_share_setopt(s_client.share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+        curl_share_setopt(s_client.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(s_client.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+        // async download engine
+        start_engine();
+    }
+
+    // takes a handle from the pool, or creates a new one if the pool is empty
+    CURL* acquire_handle()
+    {
+        CURL* curl = nullptr;
+
+        s_client.pool_mutex.lock();
+        if(!s_client.pool.empty()) {
+            curl = s_client.pool.back();
+            s_client.pool.pop_back();
+        }
+        s_client.pool_mutex.unlock();
+
+        if(!curl) {
+            curl = curl_easy_init();
+        }
+
+        if(curl) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, s_client.share);
+        }
+
+        return curl;
+    }
+
+    // returns a handle to the pool. options are reset, the shared caches stay alive
+    void release_handle(CURL* curl)
+    {
+        if(!curl) {
+            return;
+        }
+
+        curl_easy_reset(curl);
+
+        s_client.pool_mutex.lock();
+        if(s_client.pool.size() < k_max_pooled_handles) {
+            s_client.pool.push_back(curl);
+            curl = nullptr;
+        }
+        s_client.pool_mutex.unlock();
+
+        // pool is full
+        if(curl) {
+            curl_easy_cleanup(curl);
+        }
     }
 
     size_t write_function(void *ptr, size_t size, size_t nmemb, DataBuffer* db)
@@ -133,51 +462,137 @@ namespace curl
         size_t required_size = db->size + size * nmemb;
         size_t prev_pos = db->size;
 
-        // allocate. with a min alloc amount to avoid excessive small allocs
+        // allocate. geometric growth with a min alloc amount to avoid excessive small allocs and copies
         if(required_size >= db->alloc_size)
         {
             size_t new_alloc_size = std::max(required_size+1, k_min_alloc+1); // alloc with +1 space for null term
-            db->data = (u8*)realloc(db->data, new_alloc_size);
-            db->size = required_size;
-            db->alloc_size = new_alloc_size;
-            PEN_ASSERT(db->data);
+            new_alloc_size = std::max(new_alloc_size, db->alloc_size * 2);
+
+            // first write, size for the whole body when the server tells us
+            if(db->alloc_size == 0 && db->handle)
+            {
+                curl_off_t content_length = -1;
+                curl_easy_getinfo(db->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+                if(content_length > 0) {
+                    new_alloc_size = std::max(new_alloc_size, (size_t)content_length + 1);
+                }
+            }
+
+            reserve_buffer(db, new_alloc_size);
         }
 
         memcpy(db->data + prev_pos, ptr, size * nmemb);
+        db->size = required_size;
         db->data[required_size] = '\0'; // null term
         return size * nmemb;
     }
 
-    DataBuffer download(const c8* url)
+    // cache validators for conditional requests
+    struct Validators {
+        std::string etag = "";
+        std::string last_modified = "";
+    };
+
+    // picks ETag and Last-Modified out of the response headers
+    size_t header_function(c8* buffer, size_t size, size_t nitems, Validators* v)
+    {
+        size_t len = size * nitems;
+        std::string line(buffer, len);
+
+        auto sep = line.find(':');
+        if(sep != std::string::npos)
+        {
+            std::string key = line.substr(0, sep);
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+            std::string value = line.substr(sep + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t\r\n") + 1);
+
+            if(key == "etag") {
+                v->etag = value;
+            }
+            else if(key == "last-modified") {
+                v->last_modified = value;
+            }
+        }
+
+        // a redirect or 100-continue starts a new header block
+        if(line.rfind("HTTP/", 0) == 0) {
+            *v = {};
+        }
+
+        return len;
+    }
+
+    // downloads url into a buffer. when send is passed the validators are sent as If-None-Match / If-Modified-Since
+    // and a 304 comes back with no data, recv receives the validators of the response and http_code its status
+    DataBuffer download(
+        const c8* url,
+        const Validators* send = nullptr,
+        Validators* recv = nullptr,
+        long* http_code = nullptr,
+        TransferCategory_t category = TransferCategory::registry
+    )
     {
         CURL *curl;
         CURLcode res;
         DataBuffer db = {};
 
-        curl = curl_easy_init();
+        curl = acquire_handle();
 
         if(curl) {
             struct curl_slist *headers = NULL;
 
-            headers = curl_slist_append(headers, "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/117.0.0.0 Safari/537.36");
+            if(send)
+            {
+                // firebase only returns an etag when asked for one
+                headers = curl_slist_append(headers, "X-Firebase-ETag: true");
+
+                if(!send->etag.empty()) {
+                    headers = curl_slist_append(headers, ("If-None-Match: " + send->etag).c_str());
+                }
+
+                if(!send->last_modified.empty()) {
+                    headers = curl_slist_append(headers, ("If-Modified-Since: " + send->last_modified).c_str());
+                }
+            }
+
+            if(recv)
+            {
+                curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_function);
+                curl_easy_setopt(curl, CURLOPT_HEADERDATA, recv);
+            }
 
+            curl_easy_setopt(curl, CURLOPT_USERAGENT, k_browser_user_agent);
             curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
             curl_easy_setopt(curl, CURLOPT_URL, url);
             curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
             curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false);
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_function);
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, &db);
+            db.handle = curl;
+            enable_compression(curl);
 
             res = curl_easy_perform(curl);
             db.code = res;
+            record_transfer_bytes(curl, db);
+            record_telemetry(curl, category);
+
+            if(http_code) {
+                *http_code = 0;
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, http_code);
+            }
 
             if(res != CURLE_OK)
             {
                 PEN_LOG("curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
-                db.data = nullptr;
+                release_buffer(db);
             }
 
-            curl_easy_cleanup(curl);
+            curl_slist_free_all(headers);
+            release_handle(curl);
+            db.handle = nullptr;
         }
 
         return db;
@@ -187,7 +602,7 @@ namespace curl
         CURL *curl;
         DataBuffer db = {};
 
-        curl = curl_easy_init();
+        curl = acquire_handle();
 
         if(curl) {
             curl_easy_setopt(curl, CURLOPT_URL, url);
@@ -195,6 +610,7 @@ namespace curl
             curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false);
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_function);
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, &db);
+            db.handle = curl;
 
             if(data) {
                 if(method != nullptr) {
@@ -206,36 +622,42 @@ namespace curl
             struct curl_slist* headers = nullptr;
             headers = curl_slist_append(headers, "Content-Type: application/json");
             curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+            enable_compression(curl);
 
             res = curl_easy_perform(curl);
+            record_transfer_bytes(curl, db);
+            record_telemetry(curl, TransferCategory::user_data);
 
             if(res != CURLE_OK)
             {
                 PEN_LOG("curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
-                db.data = nullptr;
+                release_buffer(db);
             }
 
-            curl_easy_cleanup(curl);
+            curl_slist_free_all(headers);
+            release_handle(curl);
         }
 
+        nlohmann::json result = {};
         if(db.data)
         {
             try {
-                return nlohmann::json::parse((const c8*)db.data);
+                result = nlohmann::json::parse((const c8*)db.data);
             }
             catch(...) {
-                return {};
+                // pass
             }
         }
 
-        return {};
+        release_buffer(db);
+        return result;
     }
 
     nlohmann::json patch(const c8* url, const c8* data, CURLcode& res) {
         CURL *curl;
         DataBuffer db = {};
 
-        curl = curl_easy_init();
+        curl = acquire_handle();
 
         if(curl) {
             curl_easy_setopt(curl, CURLOPT_URL, url);
@@ -243,35 +665,42 @@ namespace curl
             curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false);
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_function);
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, &db);
+            db.handle = curl;
             curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PATCH");
             curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data);
 
             struct curl_slist* headers = nullptr;
             headers = curl_slist_append(headers, "Content-Type: application/json");
             curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+            enable_compression(curl);
 
             res = curl_easy_perform(curl);
+            record_transfer_bytes(curl, db);
+            record_telemetry(curl, TransferCategory::user_data);
 
             if(res != CURLE_OK)
             {
                 PEN_LOG("curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
-                db.data = nullptr;
+                release_buffer(db);
             }
 
-            curl_easy_cleanup(curl);
+            curl_slist_free_all(headers);
+            release_handle(curl);
         }
 
+        nlohmann::json result = {};
         if(db.data)
         {
             try {
-                return nlohmann::json::parse((const c8*)db.data);
+                result = nlohmann::json::parse((const c8*)db.data);
             }
             catch(...) {
-                return {};
+                // pass
             }
         }
 
-        return {};
+        release_buffer(db);
+        return result;
     }
 
     Str url_with_key(const c8* url) {
@@ -280,16 +709,288 @@ namespace curl
         return urlk;
     }
 
+    // opens connections to urls in parallel with HEAD requests. the resolved addresses and tls sessions end up in
+    // the share, so the first real request to each host skips the dns lookup and resumes the tls session rather
+    // than doing a full handshake. blocks until every url has connected or timed out
+    void preconnect(const std::vector<Str>& urls)
+    {
+        CURLM* multi = curl_multi_init();
+        std::vector<CURL*> handles;
+        for(auto& url : urls)
+        {
+            CURL* curl = acquire_handle();
+            if(!curl) {
+                continue;
+            }
+
+            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+            curl_easy_setopt(curl, CURLOPT_USERAGENT, k_browser_user_agent);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false);
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+            curl_multi_add_handle(multi, curl);
+            handles.push_back(curl);
+        }
+
+        s32 running = 1;
+        while(running > 0)
+        {
+            curl_multi_perform(multi, &running);
+            if(running > 0) {
+                curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+            }
+        }
+
+        for(auto* curl : handles)
+        {
+            curl_multi_remove_handle(multi, curl);
+            release_handle(curl);
+        }
+
+        curl_multi_cleanup(multi);
+    }
+
+    // downloads a batch of urls together, results line up with urls and each buffer must be returned with
+    // release_buffer. on http/2 the requests wait for and multiplex over a single connection, over http/1.1
+    // they spread across a few. failed transfers come back with no data
+    std::vector<DataBuffer> download_many(const std::vector<Str>& urls, TransferCategory_t category = TransferCategory::registry)
+    {
+        std::vector<DataBuffer> results(urls.size());
+
+        CURLM* multi = curl_multi_init();
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)k_max_concurrent_transfers);
+
+        size_t next = 0;
+        u32 in_flight = 0;
+        s32 running = 1;
+        while(next < urls.size() || in_flight > 0)
+        {
+            // keep the stream count bounded, the server caps concurrent streams per connection
+            while(next < urls.size() && in_flight < k_max_batch_streams)
+            {
+                CURL* curl = acquire_handle();
+                if(!curl) {
+                    break;
+                }
+
+                DataBuffer& db = results[next];
+                curl_easy_setopt(curl, CURLOPT_URL, urls[next].c_str());
+                curl_easy_setopt(curl, CURLOPT_USERAGENT, k_browser_user_agent);
+                curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+                curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false);
+                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_function);
+                curl_easy_setopt(curl, CURLOPT_WRITEDATA, &db);
+                curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+                curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+                curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)next);
+                db.handle = curl;
+                enable_compression(curl);
+
+                curl_multi_add_handle(multi, curl);
+                in_flight++;
+                next++;
+            }
+
+            if(in_flight == 0) {
+                break;
+            }
+
+            curl_multi_perform(multi, &running);
+
+            s32 msgs = 0;
+            while(CURLMsg* msg = curl_multi_info_read(multi, &msgs))
+            {
+                if(msg->msg != CURLMSG_DONE) {
+                    continue;
+                }
+
+                CURL* curl = msg->easy_handle;
+                void* index = nullptr;
+                curl_easy_getinfo(curl, CURLINFO_PRIVATE, &index);
+
+                DataBuffer& db = results[(size_t)index];
+                db.code = msg->data.result;
+                record_transfer_bytes(curl, db);
+                record_telemetry(curl, category);
+
+                long http_code = 0;
+                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+                if(db.code != CURLE_OK || http_code >= 400)
+                {
+                    PEN_LOG("batch transfer failed: %s %s\n", urls[(size_t)index].c_str(), curl_easy_strerror(db.code));
+                    release_buffer(db);
+                }
+
+                curl_multi_remove_handle(multi, curl);
+                release_handle(curl);
+                db.handle = nullptr;
+                in_flight--;
+            }
+
+            if(running > 0) {
+                curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+            }
+        }
+
+        curl_multi_cleanup(multi);
+        return results;
+    }
+
+    // firebase realtime database base, DIIG_FIREBASE_URL points it at a local stand-in server (app/tools/firebase_standin.py)
+    const c8* firebase_base_url()
+    {
+        static const c8* env = getenv("DIIG_FIREBASE_URL");
+        return env ? env : "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app";
+    }
+
+    Str firebase_url(const c8* path)
+    {
+        Str url = firebase_base_url();
+        url.append(path);
+        return url;
+    }
+
+    // firebase auth base, DIIG_IDENTITY_URL points it at the stand-in server as well
+    Str identity_url(const c8* path)
+    {
+        static const c8* env = getenv("DIIG_IDENTITY_URL");
+        Str url = env ? env : "https://identitytoolkit.googleapis.com";
+        url.append(path);
+        return url;
+    }
+
+    // discogs api base, DIIG_DISCOGS_API points it at a local stand-in server (app/tools/discogs_standin.py)
+    const c8* discogs_api_url()
+    {
+        static const c8* env = getenv("DIIG_DISCOGS_API");
+        return env ? env : "https://api.discogs.com";
+    }
+
+    // token bucket shared by every discogs request. the bucket refills at the per minute limit the
+    // server reports (X-Discogs-Ratelimit) and is pulled down to X-Discogs-Ratelimit-Remaining after
+    // each response, since the server's moving window is authoritative. requests overlap freely while
+    // there are tokens and queue up once the budget is spent
+    constexpr f64 k_discogs_default_limit = 60.0;
+    constexpr f64 k_discogs_429_backoff_s = 2.0;
+
+    struct DiscogsLimiter {
+        typedef std::chrono::steady_clock clock;
+
+        std::mutex          mutex;
+        f64                 limit = k_discogs_default_limit; // requests per minute
+        f64                 tokens = k_discogs_default_limit;
+        clock::time_point   last_refill = clock::now();
+        clock::time_point   blocked_until = clock::now();
+    };
+    DiscogsLimiter s_discogs_limiter;
+
+    struct DiscogsRateHeaders {
+        s32 limit = -1;
+        s32 remaining = -1;
+    };
+
+    size_t discogs_header_function(c8* buffer, size_t size, size_t nitems, DiscogsRateHeaders* rate)
+    {
+        size_t len = size * nitems;
+        std::string line(buffer, len);
+        std::transform(line.begin(), line.end(), line.begin(), ::tolower);
+
+        if(line.rfind("x-discogs-ratelimit:", 0) == 0) {
+            rate->limit = atoi(line.c_str() + 20);
+        }
+        else if(line.rfind("x-discogs-ratelimit-remaining:", 0) == 0) {
+            rate->remaining = atoi(line.c_str() + 30);
+        }
+
+        return len;
+    }
+
+    // must be called with the limiter mutex locked
+    void discogs_refill(DiscogsLimiter& l)
+    {
+        auto now = DiscogsLimiter::clock::now();
+        f64 elapsed = std::chrono::duration<f64>(now - l.last_refill).count();
+        l.tokens = std::min(l.limit, l.tokens + elapsed * l.limit / 60.0);
+        l.last_refill = now;
+    }
+
+    // blocks until a request may be made, returns false if cancel was set while waiting
+    bool discogs_acquire(const std::atomic<u32>* cancel)
+    {
+        auto& l = s_discogs_limiter;
+        for(;;)
+        {
+            if(cancel && cancel->load()) {
+                return false;
+            }
+
+            f64 wait_s = 0.0;
+            l.mutex.lock();
+            discogs_refill(l);
+
+            auto now = DiscogsLimiter::clock::now();
+            if(now < l.blocked_until) {
+                wait_s = std::chrono::duration<f64>(l.blocked_until - now).count();
+            }
+            else if(l.tokens >= 1.0) {
+                l.tokens -= 1.0;
+                l.mutex.unlock();
+                return true;
+            }
+            else {
+                wait_s = (1.0 - l.tokens) * 60.0 / l.limit;
+            }
+            l.mutex.unlock();
+
+            // sleep in small steps so cancels are responsive
+            pen::thread_sleep_ms((u32)std::max(1.0, std::min(wait_s * 1000.0, 100.0)));
+        }
+    }
+
+    void discogs_update_limits(const DiscogsRateHeaders& rate, long http_code)
+    {
+        auto& l = s_discogs_limiter;
+        l.mutex.lock();
+        discogs_refill(l);
+
+        if(rate.limit > 0) {
+            l.limit = (f64)rate.limit;
+        }
+
+        if(rate.remaining >= 0) {
+            l.tokens = std::min(l.tokens, (f64)rate.remaining);
+        }
+
+        // over budget, drain the bucket and hold off briefly before refilling
+        if(http_code == 429) {
+            l.tokens = 0.0;
+            l.blocked_until = DiscogsLimiter::clock::now() + std::chrono::milliseconds((s64)(k_discogs_429_backoff_s * 1000.0));
+        }
+        l.mutex.unlock();
+    }
+
     nlohmann::json discogs_request(
         const char *method,       // "GET", "POST", "PUT", "DELETE"
         const char *url,          // full URL
         const char *token,        // Discogs personal access token
         const char *body,         // optional JSON body (NULL for GET)
-        long *out_http_code = nullptr // optional http status (429 / 401 detection)
+        long *out_http_code = nullptr, // optional http status (429 / 401 detection)
+        const std::atomic<u32>* cancel = nullptr // optional, abandons the wait for a rate limit token
     ) {
 
+        if (out_http_code)
+            *out_http_code = -1;
+
+        // wait for budget
+        if (!discogs_acquire(cancel)) {
+            return {};
+        }
+
         // curl
-        CURL *curl = curl_easy_init();
+        CURL *curl = acquire_handle();
         if (!curl) {
             return {};
         }
@@ -319,6 +1020,13 @@ namespace curl
         DataBuffer db = {};
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_function);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &db);
+        db.handle = curl;
+        enable_compression(curl);
+
+        // rate limit headers
+        DiscogsRateHeaders rate = {};
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, discogs_header_function);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &rate);
 
         // Set HTTP method
         if (strcmp(method, "GET") == 0) {
@@ -338,36 +1046,671 @@ namespace curl
         CURLcode res = curl_easy_perform(curl);
         if (res == CURLE_OK)
             curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        record_transfer_bytes(curl, db);
+        record_telemetry(curl, TransferCategory::discogs);
+        discogs_update_limits(rate, http_code);
 
         if (out_http_code)
             *out_http_code = http_code;
 
         // cleanup
         curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
+        release_handle(curl);
 
+        nlohmann::json result = {};
         if(db.data)
         {
             try {
-                return nlohmann::json::parse((const c8*)db.data);
+                result = nlohmann::json::parse((const c8*)db.data);
             }
             catch(...) {
-                return {};
+                // pass
             }
         }
 
-        return {};
+        release_buffer(db);
+        return result;
     }
-}
 
-f64 get_like_timestamp_time()
-{
-    // this offset fixes an issue where the original timestamp code was based on mach absolute time
-    // it means any new additions after this release will appear in timestamp order, but older likes will be
-    // ordered in groups but not full consecutive
-    constexpr f64 offset = 1696155367;
-    return offset + (f64)(std::chrono::system_clock::now().time_since_epoch() / std::chrono::milliseconds(1));
-}
+    constexpr size_t k_sniff_size = 64;
+    constexpr size_t k_file_sink_buffer_size = 64 * 1024;
+
+    // checks the first bytes of a body. with validate, error responses served in place of
+    // the asset ("error code" text) are rejected
+    bool sniff_valid(const u8* data, size_t size, const c8* url, bool validate)
+    {
+        if(validate) {
+            if(size >= 10 && strncmp((const c8*)data, "error code", 10) == 0) {
+                PEN_LOG("error with url: %s\n", url);
+                return false;
+            }
+            if(size >= 15 && strncmp((const c8*)data, "<!DOCTYPE html>", 15) == 0) {
+                PEN_LOG("error with url: %s\n", url);
+            }
+        }
+
+        return true;
+    }
+
+    // streams a body to filepath.part from the write callback, which is renamed over filepath once the
+    // transfer succeeds. the first bytes are held back until they can be validated so a rejected body
+    // aborts the transfer before anything touches the disk. memory is bounded by the stdio buffer.
+    // interrupted transfers keep the .part file and a filepath.part.meta sidecar (expected length and
+    // validators) so the next attempt resumes with a range request
+    struct FileSink {
+        Str             filepath = "";
+        Str             part_filepath = "";
+        Str             meta_filepath = "";
+        Str             url = "";
+        bool            validate = false;
+        bool            rejected = false;
+        bool            range_failed = false;
+        FILE*           fp = nullptr;
+        c8*             io_buffer = nullptr;
+        u8              sniff[k_sniff_size];
+        size_t          sniff_size = 0;
+        u64             resume_from = 0;
+        long            http_code = 0;
+        CURL*           handle = nullptr;
+        curl_slist*     headers = nullptr;
+        Validators      validators = {};
+    };
+
+    size_t sink_write_function(void *ptr, size_t size, size_t nmemb, FileSink* sink);
+
+    // status of the final response, read once the body starts or before the handle is released
+    long sink_http_code(FileSink* sink)
+    {
+        if(sink->http_code == 0 && sink->handle) {
+            curl_easy_getinfo(sink->handle, CURLINFO_RESPONSE_CODE, &sink->http_code);
+        }
+        return sink->http_code;
+    }
+
+    void sink_remove_part(FileSink* sink)
+    {
+        remove(sink->part_filepath.c_str());
+        remove(sink->meta_filepath.c_str());
+    }
+
+    // sets up the sink and attaches it to handle, resuming an existing .part file when there is one
+    void sink_attach(FileSink* sink, CURL* handle, const Str& url, const Str& filepath, bool validate)
+    {
+        sink->url = url;
+        sink->filepath = filepath;
+        sink->part_filepath = filepath;
+        sink->part_filepath.append(".part");
+        sink->meta_filepath = sink->part_filepath;
+        sink->meta_filepath.append(".meta");
+        sink->validate = validate;
+        sink->handle = handle;
+
+        // the sidecar is only written once the body has been validated, without it the part can't be trusted
+        std::ifstream meta(sink->meta_filepath.c_str());
+        if(meta)
+        {
+            u64 expected = 0;
+            meta >> expected;
+            meta.ignore();
+            std::getline(meta, sink->validators.etag);
+            std::getline(meta, sink->validators.last_modified);
+
+            u32 mtime = 0;
+            pen::filesystem_getmtime(sink->part_filepath.c_str(), mtime);
+
+            FILE* fp = mtime != 0 ? fopen(sink->part_filepath.c_str(), "rb") : nullptr;
+            if(fp)
+            {
+                fseek(fp, 0, SEEK_END);
+                sink->resume_from = (u64)ftell(fp);
+                fclose(fp);
+            }
+
+            // only resume a part which is short of the expected size
+            if(sink->resume_from == 0 || (expected != 0 && sink->resume_from >= expected)) {
+                sink->resume_from = 0;
+                sink->validators = {};
+            }
+        }
+
+        if(sink->resume_from == 0) {
+            sink_remove_part(sink);
+        }
+        else {
+            // if the file changed on the server since, the server sends it whole and the range is restarted
+            const std::string& validator = !sink->validators.etag.empty() ? sink->validators.etag : sink->validators.last_modified;
+            if(!validator.empty()) {
+                sink->headers = curl_slist_append(sink->headers, ("If-Range: " + validator).c_str());
+                curl_easy_setopt(handle, CURLOPT_HTTPHEADER, sink->headers);
+            }
+
+            curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)sink->resume_from);
+            PEN_LOG("resuming: %s from %llu\n", filepath.c_str(), (unsigned long long)sink->resume_from);
+        }
+
+        curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_function);
+        curl_easy_setopt(handle, CURLOPT_HEADERDATA, &sink->validators);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, sink_write_function);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, sink);
+    }
+
+    // validates the sniffed bytes and opens the part file
+    bool sink_begin(FileSink* sink)
+    {
+        // error pages must not end up in the cache, or in the sidecar to be resumed
+        long http_code = sink_http_code(sink);
+        if(http_code != 200) {
+            PEN_LOG("error with url: %s (%ld)\n", sink->url.c_str(), http_code);
+            sink->rejected = true;
+            return false;
+        }
+
+        if(!sniff_valid(sink->sniff, sink->sniff_size, sink->url.c_str(), sink->validate)) {
+            sink->rejected = true;
+            return false;
+        }
+
+        sink->fp = fopen(sink->part_filepath.c_str(), "wb");
+        if(!sink->fp) {
+            PEN_LOG("failed to write: %s", sink->part_filepath.c_str());
+            return false;
+        }
+
+        sink->io_buffer = (c8*)malloc(k_file_sink_buffer_size);
+        setvbuf(sink->fp, sink->io_buffer, _IOFBF, k_file_sink_buffer_size);
+
+        // record what to expect, so an interrupted transfer can resume
+        curl_off_t content_length = -1;
+        curl_easy_getinfo(sink->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+
+        FILE* meta = fopen(sink->meta_filepath.c_str(), "wb");
+        if(meta)
+        {
+            fprintf(meta, "%llu\n%s\n%s\n",
+                (unsigned long long)(content_length > 0 ? content_length : 0),
+                sink->validators.etag.c_str(),
+                sink->validators.last_modified.c_str()
+            );
+            fclose(meta);
+        }
+
+        return fwrite(sink->sniff, 1, sink->sniff_size, sink->fp) == sink->sniff_size;
+    }
+
+    // appends to the part of a resumed transfer, the server must answer the range with a 206. a 200 is
+    // the whole file so the transfer restarts, any other status drops the part
+    bool sink_resume(FileSink* sink)
+    {
+        long http_code = sink_http_code(sink);
+        if(http_code != 206) {
+            if(http_code == 200) {
+                sink->range_failed = true;
+            }
+            else {
+                PEN_LOG("error with url: %s (%ld)\n", sink->url.c_str(), http_code);
+                sink->rejected = true;
+            }
+            return false;
+        }
+
+        sink->fp = fopen(sink->part_filepath.c_str(), "ab");
+        if(!sink->fp) {
+            PEN_LOG("failed to write: %s", sink->part_filepath.c_str());
+            return false;
+        }
+
+        sink->io_buffer = (c8*)malloc(k_file_sink_buffer_size);
+        setvbuf(sink->fp, sink->io_buffer, _IOFBF, k_file_sink_buffer_size);
+        return true;
+    }
+
+    // returning short of the full size aborts the transfer with CURLE_WRITE_ERROR
+    size_t sink_write_function(void *ptr, size_t size, size_t nmemb, FileSink* sink)
+    {
+        size_t len = size * nmemb;
+        const u8* src = (const u8*)ptr;
+
+        if(!sink->fp)
+        {
+            if(sink->rejected || sink->range_failed) {
+                return 0;
+            }
+
+            // the start of the body was validated by the transfer which wrote the part
+            if(sink->resume_from > 0) {
+                if(!sink_resume(sink)) {
+                    return 0;
+                }
+            }
+            else {
+                size_t n = std::min(len, k_sniff_size - sink->sniff_size);
+                memcpy(sink->sniff + sink->sniff_size, src, n);
+                sink->sniff_size += n;
+
+                // keep sniffing
+                if(sink->sniff_size < k_sniff_size) {
+                    return len;
+                }
+
+                if(!sink_begin(sink)) {
+                    return 0;
+                }
+
+                src += n;
+                len -= n;
+                if(fwrite(src, 1, len, sink->fp) != len) {
+                    return 0;
+                }
+
+                return size * nmemb;
+            }
+        }
+
+        if(fwrite(src, 1, len, sink->fp) != len) {
+            return 0;
+        }
+
+        return len;
+    }
+
+    // call before the handle is released. only a 200, or a 206 answering our range, is the asset. error
+    // responses without a body never reach the write callback so they are caught here, a transfer which
+    // got no response at all keeps its part to resume
+    void sink_check_status(FileSink* sink)
+    {
+        long http_code = sink_http_code(sink);
+        bool ok = http_code == 200 || (http_code == 206 && sink->resume_from > 0);
+        if(http_code != 0 && !ok && !sink->range_failed) {
+            sink->rejected = true;
+        }
+        sink->handle = nullptr;
+    }
+
+    // the server would not serve the range, the part is dropped and the transfer has to start over. a 200 or
+    // a failed If-Range usually ends the transfer with CURLE_RANGE_ERROR before the write callback runs, so
+    // the range is marked failed here too, otherwise sink_finish would keep the part to resume it again
+    bool sink_needs_restart(FileSink* sink, CURLcode res)
+    {
+        if(sink->resume_from > 0 && res == CURLE_RANGE_ERROR) {
+            sink->range_failed = true;
+        }
+        return sink->range_failed;
+    }
+
+    // closes the part file and moves it into place on success. interrupted transfers keep the part
+    // to resume from, unless keep_part is false. returns true if filepath was written
+    bool sink_finish(FileSink* sink, bool success, bool keep_part)
+    {
+        // bodies shorter than the sniff size are validated here
+        if(success && !sink->fp && !sink->rejected && sink->resume_from == 0 && sink->sniff_size > 0) {
+            success = sink_begin(sink);
+        }
+
+        success &= (sink->fp != nullptr);
+
+        if(sink->fp) {
+            success &= (fclose(sink->fp) == 0);
+            sink->fp = nullptr;
+
+            if(success) {
+                success = (rename(sink->part_filepath.c_str(), sink->filepath.c_str()) == 0);
+            }
+        }
+
+        if(success || !keep_part || sink->rejected || sink->range_failed) {
+            sink_remove_part(sink);
+        }
+
+        free(sink->io_buffer);
+        sink->io_buffer = nullptr;
+
+        curl_slist_free_all(sink->headers);
+        sink->headers = nullptr;
+
+        return success;
+    }
+
+    //
+    // async download engine
+    //
+
+    typedef std::function<void(const Str& filepath, bool cancelled)> TransferCallback;
+
+    // one party waiting on a transfer. the id returned from submit identifies the requester
+    struct Requester {
+        u64                 id = 0;
+        u64                 priority = 0;
+        bool                cancelled = false;
+        TransferCallback    on_complete = nullptr;
+    };
+
+    // a file download driven by the multi engine, the body is streamed to disk and moved to filepath
+    // on completion and then each requester's on_complete is called from the engine thread. requests for
+    // a file which is already in flight attach to the existing transfer instead of starting another, so
+    // two transfers never write the same .part or target file.
+    // cancelled requesters still complete (with cancelled = true) so they can clean up their book keeping
+    struct Transfer {
+        u64                     priority = 0; // lower starts sooner
+        bool                    cancelled = false;
+        Str                     url = "";
+        Str                     filepath = "";
+        bool                    validate = false;
+        bool                    restarted = false; // a refused range restarts the transfer once
+        TransferCategory_t      category = TransferCategory::artwork;
+        TransferCallback        on_complete = nullptr; // the submitter, moved into requesters by submit
+        std::vector<Requester>  requesters;
+        FileSink                sink = {};
+        CURL*                   handle = nullptr;
+    };
+
+    struct Engine {
+        CURLM*                              multi = nullptr;
+        std::mutex                          mutex;
+        std::vector<Transfer*>              pending;
+        std::vector<Transfer*>              active;
+        std::map<std::string, Transfer*>    in_flight; // by target filepath
+        std::map<u64, Transfer*>            tickets; // by requester id
+        u64                                 next_id = 1;
+    };
+    Engine s_engine;
+
+    void wakeup()
+    {
+        // break the engine out of its poll so changes are picked up immediately, null before curl::init
+        if(s_engine.multi) {
+            curl_multi_wakeup(s_engine.multi);
+        }
+    }
+
+    // must be called with the engine mutex locked. a transfer runs at the most urgent of its requesters
+    void update_priority(Transfer* t)
+    {
+        bool first = true;
+        for(auto& r : t->requesters) {
+            if(!r.cancelled && (first || r.priority < t->priority)) {
+                t->priority = r.priority;
+                first = false;
+            }
+        }
+    }
+
+    // queue a transfer, the engine owns it from here and deletes it after completion. if the url is
+    // already in flight t is dropped and the requester attaches to the existing transfer.
+    // returns an id which can be used to re-prioritise or cancel the request
+    u64 submit(Transfer* t)
+    {
+        s_engine.mutex.lock();
+        u64 id = s_engine.next_id++;
+
+        Requester r;
+        r.id = id;
+        r.priority = t->priority;
+        r.on_complete = std::move(t->on_complete);
+
+        auto it = s_engine.in_flight.find(t->filepath.c_str());
+        if(it != s_engine.in_flight.end())
+        {
+            // attach, reviving the transfer if everyone else had given up on it
+            Transfer* existing = it->second;
+            existing->requesters.push_back(std::move(r));
+            existing->cancelled = false;
+            update_priority(existing);
+            s_engine.tickets[id] = existing;
+            s_engine.mutex.unlock();
+
+            delete t;
+            return id;
+        }
+
+        t->requesters.push_back(std::move(r));
+        s_engine.in_flight[t->filepath.c_str()] = t;
+        s_engine.tickets[id] = t;
+        s_engine.pending.push_back(t);
+        s_engine.mutex.unlock();
+
+        wakeup();
+        return id;
+    }
+
+    // only affects transfers which have not started yet
+    void set_priority(u64 id, u64 priority)
+    {
+        s_engine.mutex.lock();
+        auto it = s_engine.tickets.find(id);
+        if(it != s_engine.tickets.end())
+        {
+            Transfer* t = it->second;
+            for(auto& r : t->requesters) {
+                if(r.id == id) {
+                    r.priority = priority;
+                }
+            }
+            update_priority(t);
+        }
+        s_engine.mutex.unlock();
+    }
+
+    // cancels a request. other requesters of the same url keep the transfer going and the cancelled one is
+    // completed straight away, once nobody wants it the transfer itself is cancelled and the partial body
+    // is kept as a .part to resume from
+    void cancel(u64 id)
+    {
+        TransferCallback detached = nullptr;
+        Str filepath = "";
+        bool cancel_transfer = false;
+
+        s_engine.mutex.lock();
+        auto it = s_engine.tickets.find(id);
+        if(it != s_engine.tickets.end())
+        {
+            Transfer* t = it->second;
+            u32 live = 0;
+            for(auto& r : t->requesters) {
+                if(r.id == id) {
+                    r.cancelled = true;
+                }
+                live += r.cancelled ? 0 : 1;
+            }
+
+            if(live == 0)
+            {
+                cancel_transfer = !t->cancelled;
+                t->cancelled = true;
+            }
+            else
+            {
+                auto r = std::find_if(t->requesters.begin(), t->requesters.end(), [id](const Requester& r) {
+                    return r.id == id;
+                });
+
+                detached = std::move(r->on_complete);
+                filepath = t->filepath;
+                t->requesters.erase(r);
+                s_engine.tickets.erase(it);
+                update_priority(t);
+            }
+        }
+        s_engine.mutex.unlock();
+
+        if(detached) {
+            detached(filepath, true);
+        }
+
+        if(cancel_transfer) {
+            wakeup();
+        }
+    }
+
+    void start_transfer(Transfer* t)
+    {
+        t->handle = acquire_handle();
+
+        curl_easy_setopt(t->handle, CURLOPT_URL, t->url.c_str());
+        curl_easy_setopt(t->handle, CURLOPT_USERAGENT, k_browser_user_agent);
+        curl_easy_setopt(t->handle, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(t->handle, CURLOPT_SSL_VERIFYPEER, false);
+        sink_attach(&t->sink, t->handle, t->url, t->filepath, t->validate);
+        curl_easy_setopt(t->handle, CURLOPT_PRIVATE, t);
+
+        // stalled transfers must not hold on to one of the concurrency slots forever
+        curl_easy_setopt(t->handle, CURLOPT_CONNECTTIMEOUT, 10L);
+        curl_easy_setopt(t->handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+        curl_easy_setopt(t->handle, CURLOPT_LOW_SPEED_TIME, 30L);
+        curl_easy_setopt(t->handle, CURLOPT_NOSIGNAL, 1L);
+
+        curl_multi_add_handle(s_engine.multi, t->handle);
+    }
+
+    void finish_transfer(Transfer* t, CURLcode res)
+    {
+        // transfers cancelled before they started have no handle
+        if(t->handle) {
+            s_engine.mutex.lock();
+            s_engine.active.erase(std::find(s_engine.active.begin(), s_engine.active.end(), t));
+            s_engine.mutex.unlock();
+
+            // cancelled transfers only report how far they got
+            if(!t->cancelled) {
+                record_telemetry(t->handle, t->category);
+            }
+
+            sink_check_status(&t->sink);
+            curl_multi_remove_handle(s_engine.multi, t->handle);
+            release_handle(t->handle);
+        }
+
+        bool restart = !t->cancelled && sink_needs_restart(&t->sink, res) && !t->restarted;
+        if(!t->cancelled && res != CURLE_OK && !t->sink.rejected && !restart)
+        {
+            PEN_LOG("curl transfer failed: %s %s\n", t->url.c_str(), curl_easy_strerror(res));
+        }
+
+        // cancelled and failed partial bodies are kept to resume from next time
+        sink_finish(&t->sink, !t->cancelled && res == CURLE_OK, true);
+
+        // range was refused, queue again for a full fetch
+        if(restart)
+        {
+            t->sink = {};
+            t->handle = nullptr;
+            t->restarted = true;
+
+            s_engine.mutex.lock();
+            s_engine.pending.push_back(t);
+            s_engine.mutex.unlock();
+            return;
+        }
+
+        // detach from the tables, later requests for the url start a new transfer
+        s_engine.mutex.lock();
+        auto it = s_engine.in_flight.find(t->filepath.c_str());
+        if(it != s_engine.in_flight.end() && it->second == t) {
+            s_engine.in_flight.erase(it);
+        }
+
+        for(auto& r : t->requesters) {
+            s_engine.tickets.erase(r.id);
+        }
+        s_engine.mutex.unlock();
+
+        for(auto& r : t->requesters) {
+            if(r.on_complete) {
+                r.on_complete(t->filepath, t->cancelled || r.cancelled);
+            }
+        }
+
+        delete t;
+    }
+
+    void* engine_thread(void* userdata)
+    {
+        std::vector<Transfer*> cancelled;
+        for(;;)
+        {
+            s_engine.mutex.lock();
+
+            // collect cancellations, queued and in flight
+            cancelled.clear();
+            for(size_t i = 0; i < s_engine.pending.size();) {
+                if(s_engine.pending[i]->cancelled) {
+                    cancelled.push_back(s_engine.pending[i]);
+                    s_engine.pending.erase(s_engine.pending.begin() + i);
+                    continue;
+                }
+                ++i;
+            }
+
+            for(auto* t : s_engine.active) {
+                if(t->cancelled) {
+                    cancelled.push_back(t);
+                }
+            }
+
+            // from here they can't be revived, new requests for the url start over
+            for(auto* t : cancelled) {
+                auto it = s_engine.in_flight.find(t->filepath.c_str());
+                if(it != s_engine.in_flight.end() && it->second == t) {
+                    s_engine.in_flight.erase(it);
+                }
+            }
+
+            // start pending transfers up to the concurrency limit, lowest priority value first
+            while(!s_engine.pending.empty() && s_engine.active.size() < k_max_concurrent_transfers)
+            {
+                auto next = std::min_element(s_engine.pending.begin(), s_engine.pending.end(), [](Transfer* a, Transfer* b) {
+                    return a->priority < b->priority;
+                });
+
+                Transfer* t = *next;
+                s_engine.pending.erase(next);
+                s_engine.active.push_back(t);
+                start_transfer(t);
+            }
+            s_engine.mutex.unlock();
+
+            for(auto* t : cancelled) {
+                finish_transfer(t, CURLE_ABORTED_BY_CALLBACK);
+            }
+
+            s32 running = 0;
+            curl_multi_perform(s_engine.multi, &running);
+
+            // completions
+            s32 msgs = 0;
+            while(CURLMsg* msg = curl_multi_info_read(s_engine.multi, &msgs))
+            {
+                if(msg->msg != CURLMSG_DONE) {
+                    continue;
+                }
+
+                Transfer* t = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &t);
+                finish_transfer(t, msg->data.result);
+            }
+
+            // sleeps until there is socket activity, a submit wakes it or the timeout expires
+            curl_multi_poll(s_engine.multi, nullptr, 0, 100, nullptr);
+        }
+
+        return nullptr;
+    }
+
+    // the multi is created before the thread starts and never changes, so wakeup can read it from any thread
+    void start_engine()
+    {
+        s_engine.multi = curl_multi_init();
+        pen::thread_create(engine_thread, 10 * 1024 * 1024, nullptr, pen::e_thread_start_flags::detached);
+    }
+}
+
+f64 get_like_timestamp_time()
+{
+    // this offset fixes an issue where the original timestamp code was based on mach absolute time
+    // it means any new additions after this release will appear in timestamp order, but older likes will be
+    // ordered in groups but not full consecutive
+    constexpr f64 offset = 1696155367;
+    return offset + (f64)(std::chrono::system_clock::now().time_since_epoch() / std::chrono::milliseconds(1));
+}
 
 generic_cmp_array& get_component_array(soa& s, size_t i)
 {
@@ -491,11 +1834,16 @@ bool check_audio_file(const Str& path)
     return true;
 }
 
-Str download_and_cache(const Str& url, Str releaseid, bool validate = false)
+Str fixup_download_url(const Str& url)
 {
+    // juno artwork urls can carry a doubled size suffix
     Str url2 = pen::str_replace_string(url, "MED-MED", "MED");
     url2 = pen::str_replace_string(url2, "MED-BIG", "BIG");
+    return url2;
+}
 
+Str release_cache_filepath(const Str& url, const Str& releaseid)
+{
     Str filepath = pen::str_replace_string(url, "https://", "");
     filepath = pen::str_replace_chars(filepath, '/', '_');
 
@@ -510,51 +1858,37 @@ Str download_and_cache(const Str& url, Str releaseid, bool validate = false)
     // force remove mp3
     filepath = pen::str_replace_string(filepath, ".mp3", "");
 
-    // check if file already exists
+    return filepath;
+}
+
+// caches a release asset. files already in the cache complete immediately on the calling thread and
+// 0 is returned, otherwise the download is queued on the curl engine with priority and the transfer id
+// is returned. on_complete is called from the engine thread once the file is written
+u64 download_and_cache_async(const Str& url, Str releaseid, bool validate, TransferCategory_t category, u64 priority, curl::TransferCallback on_complete)
+{
+    Str filepath = release_cache_filepath(url, releaseid);
+
     u32 mtime = 0;
     pen::filesystem_getmtime(filepath.c_str(), mtime);
-    if(mtime == 0)
+    if(mtime != 0)
     {
-        // mkdirs
-        pen::os_create_directory(dir.c_str());
+        on_complete(filepath, false);
+        return 0;
+    }
 
-        // download
-        auto db = new curl::DataBuffer;
-        *db = curl::download(url2.c_str());
-
-        // try parse json to validate
-        bool error_response = false;
-        if(validate) {
-            if(db->data) {
-                if(strncmp((const c8*)db->data, "error code", 10) == 0) {
-                    PEN_LOG("error with url: %s\n", url2.c_str());
-                    error_response = true;
-                }
-                if(strncmp((const c8*)db->data, "<!DOCTYPE html>", 15) == 0) {
-                    PEN_LOG("error with url: %s\n", url2.c_str());
-                }
-            }
-        }
-
-        // stash
-        if(db->data)
-        {
-            if(!error_response)
-            {
-                FILE* fp = fopen(filepath.c_str(), "wb");
-                if(fp)
-                {
-                    fwrite(db->data, db->size, 1, fp);
-                    fclose(fp);
-                }
-            }
-
-            // free
-            free(db->data);
-        }
-    }
-
-    return filepath;
+    // mkdirs
+    Str dir = get_cache_path();
+    dir.appendf("/%s", releaseid.c_str());
+    pen::os_create_directory(dir.c_str());
+
+    auto t = new curl::Transfer;
+    t->url = fixup_download_url(url);
+    t->filepath = filepath;
+    t->validate = validate;
+    t->category = category;
+    t->priority = priority;
+    t->on_complete = on_complete;
+    return curl::submit(t);
 }
 
 Str get_persistent_filepath(const Str& basename, bool create_dirs = false)
@@ -582,40 +1916,6 @@ Str get_persistent_filepath(const Str& basename, bool create_dirs = false)
     return filepath;
 }
 
-Str download_and_cache_named(const Str& url, const Str& filename)
-{
-    Str dir = os_get_persistent_data_directory();
-    dir.appendf("/dig");
-
-    // filepath
-    Str path = dir;
-    path.appendf("/%s", filename.c_str());
-    Str filepath = path;
-
-    // check if file already exists
-    u32 mtime = 0;
-    pen::filesystem_getmtime(filepath.c_str(), mtime);
-    if(mtime == 0)
-    {
-        // mkdirs
-        pen::os_create_directory(dir.c_str());
-    }
-
-    // download
-    auto db = new curl::DataBuffer;
-    *db = curl::download(url.c_str());
-
-    // stash
-    FILE* fp = fopen(filepath.c_str(), "wb");
-    fwrite(db->data, db->size, 1, fp);
-    fclose(fp);
-
-    // free
-    free(db->data);
-
-    return filepath;
-}
-
 pen::texture_creation_params load_texture_from_disk(const Str& filepath)
 {
     // check file exists
@@ -695,13 +1995,184 @@ pen::texture_creation_params load_texture_from_disk(const Str& filepath)
     return tcp;
 }
 
+// checks a parsed firebase response for an error payload: {"error": "..."}
+bool is_firebase_error(const nlohmann::json& dict)
+{
+    if(dict.size() == 1) {
+        for(auto& item : dict.items()) {
+            if(item.key() == "error") {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// parsed copies of the json cache files of dicts (stores.json) keyed by filepath, so a 304 or a repeat load
+// costs no parsing. registry pages go through snapshots and are not kept here. entries are shared and
+// immutable, the least recently used is dropped past k_max_parsed_json
+constexpr size_t k_max_parsed_json = 4;
+
+struct ParsedJsonCache {
+    std::mutex                                                                  mutex;
+    std::vector<std::pair<std::string, std::shared_ptr<const nlohmann::json>>>  entries; // most recent last
+};
+ParsedJsonCache s_parsed_json_cache;
+
+// keeps a copy of async_dict.dict for filepath, call with the async_dict mutex held
+void store_parsed_json(const Str& filepath, AsyncDict& async_dict)
+{
+    auto entry = std::make_shared<const nlohmann::json>(async_dict.dict);
+    async_dict.parsed = entry;
+
+    std::lock_guard<std::mutex> lock(s_parsed_json_cache.mutex);
+    auto& entries = s_parsed_json_cache.entries;
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&filepath](const auto& e) {
+        return e.first == filepath.c_str();
+    }), entries.end());
+
+    if(entries.size() >= k_max_parsed_json) {
+        entries.erase(entries.begin());
+    }
+    entries.push_back({filepath.c_str(), std::move(entry)});
+}
+
+// serves async_dict from the parsed cache. a dict which already holds the entry is left as it is, so a 304
+// against data already loaded does no json work at all
+bool load_parsed_json(const Str& filepath, AsyncDict& async_dict)
+{
+    std::shared_ptr<const nlohmann::json> entry;
+    s_parsed_json_cache.mutex.lock();
+    auto& entries = s_parsed_json_cache.entries;
+    for(size_t i = 0; i < entries.size(); ++i) {
+        if(entries[i].first == filepath.c_str()) {
+            entry = entries[i].second;
+            std::rotate(entries.begin() + i, entries.begin() + i + 1, entries.end());
+            break;
+        }
+    }
+    s_parsed_json_cache.mutex.unlock();
+
+    if(!entry) {
+        return false;
+    }
+
+    async_dict.mutex.lock();
+    if(async_dict.parsed != entry) {
+        async_dict.dict = *entry;
+        async_dict.parsed = entry;
+    }
+    async_dict.status = Status::e_ready;
+    async_dict.mutex.unlock();
+    return true;
+}
+
+// etag / last-modified of a cache file are kept in a sidecar: filepath.meta, one per line
+curl::Validators read_validators(const Str& filepath)
+{
+    curl::Validators v;
+    std::ifstream meta((std::string(filepath.c_str()) + ".meta").c_str());
+    if(meta) {
+        std::getline(meta, v.etag);
+        std::getline(meta, v.last_modified);
+    }
+    return v;
+}
+
+void write_validators(const Str& filepath, const curl::Validators& v)
+{
+    Str meta_filepath = filepath;
+    meta_filepath.append(".meta");
+
+    FILE* fp = fopen(meta_filepath.c_str(), "wb");
+    if(fp)
+    {
+        fprintf(fp, "%s\n%s\n", v.etag.c_str(), v.last_modified.c_str());
+        fclose(fp);
+    }
+}
+
+// loads a previously cached json file into async_dict
+bool load_json_cache(const Str& filepath, AsyncDict& async_dict)
+{
+    if(load_parsed_json(filepath, async_dict)) {
+        return true;
+    }
+
+    u32 mtime = 0;
+    pen::filesystem_getmtime(filepath.c_str(), mtime);
+    if(mtime == 0) {
+        PEN_LOG("no cache for: %s", filepath.c_str());
+        async_dict.status = Status::e_not_available;
+        return false;
+    }
+
+    // ensures it's valid
+    async_dict.mutex.lock();
+    try {
+        async_dict.dict = nlohmann::json::parse(std::ifstream(filepath.c_str()));
+        async_dict.status = Status::e_ready;
+
+        // check for firebase errors
+        if(is_firebase_error(async_dict.dict)) {
+            PEN_LOG("cached error: %s", async_dict.dict.dump(4).c_str());
+            async_dict.status = Status::e_not_initialised;
+        }
+    } catch (...) {
+        async_dict.status = Status::e_not_available;
+    }
+
+    if(async_dict.status == Status::e_ready) {
+        store_parsed_json(filepath, async_dict);
+    }
+    async_dict.mutex.unlock();
+
+    return async_dict.status == Status::e_ready;
+}
+
 // fetches json from a url and caches it to persistent_directory/cache_filename
 // if the url fetch fails it will load data from a previously cached file if it exists
 // if no cached file exists and the url fetch fails then false is returned and the async_dict.status is set to DataStatus::e_not_available
-bool fetch_json_cache(const c8* url, const c8* cache_filename, AsyncDict& async_dict)
+// with CachePolicy::stale_while_revalidate a cached file is served first without fetching and async_dict.stale is set,
+// the caller can then refresh it in the background with revalidate_json_cache
+bool fetch_json_cache(const c8* url, const c8* cache_filename, AsyncDict& async_dict, CachePolicy_t policy = CachePolicy::network_first)
 {
-    pen::scope_timer(cache_filename, true);
-    auto j = curl::download(url);
+    auto tt = pen::scope_timer(cache_filename, true);
+
+    Str filepath = get_persistent_filepath(cache_filename, true);
+    if(policy != CachePolicy::network_first)
+    {
+        if(load_json_cache(filepath, async_dict))
+        {
+            async_dict.stale = (policy == CachePolicy::stale_while_revalidate);
+            return true;
+        }
+    }
+
+    // conditional request against the validators of the cached file, a 304 means the cache is current
+    async_dict.stale = false;
+    curl::Validators validators;
+    u32 mtime = 0;
+    pen::filesystem_getmtime(filepath.c_str(), mtime);
+    if(mtime != 0) {
+        validators = read_validators(filepath);
+    }
+
+    curl::Validators received;
+    long http_code = 0;
+    auto j = curl::download(url, &validators, &received, &http_code);
+    if(http_code == 304)
+    {
+        curl::release_buffer(j);
+        if(load_json_cache(filepath, async_dict)) {
+            return true;
+        }
+
+        // the cache went missing underneath the validators, fetch unconditionally
+        j = curl::download(url, nullptr, &received, &http_code);
+    }
+
     if(j.data)
     {
         async_dict.mutex.lock();
@@ -710,95 +2181,672 @@ bool fetch_json_cache(const c8* url, const c8* cache_filename, AsyncDict& async_
             async_dict.status = Status::e_ready;
 
             // check for firebase errors
-            if(async_dict.dict.size() == 1) {
-                for(auto& item : async_dict.dict.items()) {
-                    if(item.key() == "error") {
-                        PEN_LOG("error: %s", async_dict.dict.dump(4).c_str());
-                        async_dict.status = Status::e_not_initialised;
-                    }
+            if(is_firebase_error(async_dict.dict)) {
+                PEN_LOG("error: %s", async_dict.dict.dump(4).c_str());
+                async_dict.status = Status::e_not_initialised;
+            }
+        }
+        catch(...) {
+            async_dict.status = Status::e_not_initialised;
+        }
+        async_dict.mutex.unlock();
+    }
+
+    if(async_dict.status == Status::e_ready)
+    {
+        async_dict.mutex.lock();
+        store_parsed_json(filepath, async_dict);
+        async_dict.mutex.unlock();
+
+        // cache async
+        std::thread cache_thread([j, filepath, received]() mutable {
+            FILE* fp = fopen(filepath.c_str(), "wb");
+            if(fp)
+            {
+                fwrite(j.data, j.size, 1, fp);
+                fclose(fp);
+                write_validators(filepath, received);
+            }
+            else
+            {
+                PEN_LOG("failed to write: %s", filepath.c_str());
+            }
+            curl::release_buffer(j); // cleanup
+        });
+        cache_thread.detach();
+    }
+    else
+    {
+        // check for a cached item
+        if(load_json_cache(filepath, async_dict)) {
+            PEN_LOG("fallback to cache: %s", filepath.c_str());
+        }
+
+        // cleanup
+        curl::release_buffer(j);
+    }
+
+    return async_dict.status == Status::e_ready;
+}
+
+// conditional fetch of url against the validators of the cache file at filepath. returns true when the body
+// in j differs from the cached bytes, received holds the response validators. j must be released
+bool revalidate_cache_body(const c8* url, const Str& filepath, curl::DataBuffer& j, curl::Validators& received)
+{
+    curl::Validators validators = read_validators(filepath);
+    long http_code = 0;
+    j = curl::download(url, &validators, &received, &http_code);
+    if(http_code == 304 || !j.data) {
+        return false;
+    }
+
+    // compare with the cached bytes
+    bool changed = true;
+    FILE* fp = fopen(filepath.c_str(), "rb");
+    if(fp)
+    {
+        fseek(fp, 0, SEEK_END);
+        size_t size = ftell(fp);
+        rewind(fp);
+
+        if(size == j.size)
+        {
+            u8* cached = (u8*)malloc(size);
+            changed = fread(cached, 1, size, fp) != size || memcmp(cached, j.data, size) != 0;
+            free(cached);
+        }
+
+        fclose(fp);
+    }
+
+    return changed;
+}
+
+void write_cache_body(const Str& filepath, const curl::DataBuffer& j)
+{
+    FILE* fp = fopen(filepath.c_str(), "wb");
+    if(fp)
+    {
+        fwrite(j.data, j.size, 1, fp);
+        fclose(fp);
+    }
+    PEN_LOG("revalidated: %s", filepath.c_str());
+}
+
+// fetches url and updates the cache file if the response differs from it. returns true when
+// fresher data was written, in which case fresh.dict holds it. runs synchronously, call it from
+// a worker thread after serving the stale data
+bool revalidate_json_cache(const c8* url, const c8* cache_filename, AsyncDict& fresh)
+{
+    auto tt = pen::scope_timer(cache_filename, true);
+
+    Str filepath = get_persistent_filepath(cache_filename, true);
+
+    curl::DataBuffer j;
+    curl::Validators received;
+    bool changed = revalidate_cache_body(url, filepath, j, received);
+    if(changed)
+    {
+        fresh.mutex.lock();
+        try {
+            fresh.dict = nlohmann::json::parse((const c8*)j.data);
+            fresh.status = is_firebase_error(fresh.dict) ? Status::e_not_initialised : Status::e_ready;
+        }
+        catch(...) {
+            fresh.status = Status::e_not_initialised;
+        }
+        fresh.mutex.unlock();
+
+        changed = (fresh.status == Status::e_ready);
+        if(changed)
+        {
+            store_parsed_json(filepath, fresh);
+            write_cache_body(filepath, j);
+        }
+    }
+
+    // keep validators current even when the body was the same
+    if(j.data) {
+        write_validators(filepath, received);
+    }
+
+    curl::release_buffer(j);
+    return changed;
+}
+
+RegistrySnapshot::~RegistrySnapshot()
+{
+#if !PEN_PLATFORM_WIN32
+    if(mapped) {
+        munmap(mapped, mapped_size);
+    }
+#endif
+}
+
+// reads a snapshot written by write_registry_snapshot into out, no json is touched
+bool load_registry_snapshot_file(const Str& filepath, std::vector<u8>& out)
+{
+    FILE* fp = fopen(filepath.c_str(), "rb");
+    if(!fp) {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size_t size = ftell(fp);
+    rewind(fp);
+
+    out.resize(size);
+    bool read = fread(out.data(), 1, size, fp) == size;
+    fclose(fp);
+
+    RegistrySnapshot check;
+    return read && fixup_registry_snapshot(check, out.data(), out.size());
+}
+
+// reads a cached registry json file straight into a snapshot
+bool load_registry_json(const Str& filepath, const c8* index_on, std::vector<u8>& out)
+{
+    FILE* fp = fopen(filepath.c_str(), "rb");
+    if(!fp) {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size_t size = ftell(fp);
+    rewind(fp);
+
+    std::vector<c8> data(size);
+    bool read = fread(data.data(), 1, size, fp) == size;
+    fclose(fp);
+
+    return read && read_registry_snapshot(data.data(), data.size(), index_on, out);
+}
+
+// fetch_json_cache for registry pages, the same cache file, validators and policies but the response goes
+// through the on demand reader into a snapshot instead of a dict. stale is set when served from the cache
+// under stale_while_revalidate. on a 304 the page's snapshot at snapshot_filepath is reused, the json is
+// only read again if the snapshot is missing
+bool fetch_registry_snapshot(
+    const c8* url, const c8* cache_filename, const Str& snapshot_filepath, const c8* index_on, std::vector<u8>& out, CachePolicy_t policy, bool& stale)
+{
+    auto tt = pen::scope_timer(cache_filename, true);
+
+    stale = false;
+    Str filepath = get_persistent_filepath(cache_filename, true);
+    if(policy != CachePolicy::network_first)
+    {
+        if(load_registry_json(filepath, index_on, out))
+        {
+            stale = (policy == CachePolicy::stale_while_revalidate);
+            return true;
+        }
+    }
+
+    // conditional request against the validators of the cached file, a 304 means the cache is current
+    curl::Validators validators;
+    u32 mtime = 0;
+    pen::filesystem_getmtime(filepath.c_str(), mtime);
+    if(mtime != 0) {
+        validators = read_validators(filepath);
+    }
+
+    curl::Validators received;
+    long http_code = 0;
+    auto j = curl::download(url, &validators, &received, &http_code);
+    if(http_code == 304)
+    {
+        curl::release_buffer(j);
+        if(load_registry_snapshot_file(snapshot_filepath, out) || load_registry_json(filepath, index_on, out)) {
+            return true;
+        }
+
+        // the cache went missing underneath the validators, fetch unconditionally
+        j = curl::download(url, nullptr, &received, &http_code);
+    }
+
+    if(j.data && read_registry_snapshot((const c8*)j.data, j.size, index_on, out))
+    {
+        // cache async
+        std::thread cache_thread([j, filepath, received]() mutable {
+            FILE* fp = fopen(filepath.c_str(), "wb");
+            if(fp)
+            {
+                fwrite(j.data, j.size, 1, fp);
+                fclose(fp);
+                write_validators(filepath, received);
+            }
+            else
+            {
+                PEN_LOG("failed to write: %s", filepath.c_str());
+            }
+            curl::release_buffer(j); // cleanup
+        });
+        cache_thread.detach();
+        return true;
+    }
+
+    curl::release_buffer(j);
+
+    // check for a cached item
+    if(load_registry_json(filepath, index_on, out)) {
+        PEN_LOG("fallback to cache: %s", filepath.c_str());
+        return true;
+    }
+
+    return false;
+}
+
+// revalidate_json_cache for registry pages, a changed body goes through the on demand reader into out
+// instead of a dict. returns true when fresher data was written
+bool revalidate_registry_snapshot(const c8* url, const c8* cache_filename, const c8* index_on, std::vector<u8>& out)
+{
+    auto tt = pen::scope_timer(cache_filename, true);
+
+    Str filepath = get_persistent_filepath(cache_filename, true);
+
+    curl::DataBuffer j;
+    curl::Validators received;
+    bool changed = revalidate_cache_body(url, filepath, j, received);
+    if(changed)
+    {
+        changed = read_registry_snapshot((const c8*)j.data, j.size, index_on, out);
+        if(changed) {
+            write_cache_body(filepath, j);
+        }
+    }
+
+    // keep validators current even when the body was the same
+    if(j.data) {
+        write_validators(filepath, received);
+    }
+
+    curl::release_buffer(j);
+    return changed;
+}
+
+// maps a snapshot written by write_registry_snapshot, win32 reads it into the buffer instead
+bool map_registry_snapshot(const Str& filepath, RegistrySnapshot& snapshot)
+{
+    auto tt = pen::scope_timer(filepath.c_str(), true);
+
+#if PEN_PLATFORM_WIN32
+    FILE* fp = fopen(filepath.c_str(), "rb");
+    if(!fp) {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size_t size = ftell(fp);
+    rewind(fp);
+
+    snapshot.buffer.resize(size);
+    bool read = fread(snapshot.buffer.data(), 1, size, fp) == size;
+    fclose(fp);
+
+    return read && fixup_registry_snapshot(snapshot, snapshot.buffer.data(), size);
+#else
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(mapped == MAP_FAILED) {
+        return false;
+    }
+
+    snapshot.mapped = mapped;
+    snapshot.mapped_size = (size_t)st.st_size;
+    return fixup_registry_snapshot(snapshot, (const u8*)mapped, snapshot.mapped_size);
+#endif
+}
+
+// writes to a temp file and renames it over filepath, so readers (and views which have it mapped) keep a valid copy
+void write_file_replace(const Str& filepath, const void* data, size_t size)
+{
+    Str tmp_filepath = filepath;
+    tmp_filepath.append(".tmp");
+
+    FILE* fp = fopen(tmp_filepath.c_str(), "wb");
+    if(!fp) {
+        PEN_LOG("failed to write: %s", tmp_filepath.c_str());
+        return;
+    }
+
+    fwrite(data, size, 1, fp);
+    fclose(fp);
+
+#if PEN_PLATFORM_WIN32
+    remove(filepath.c_str());
+#endif
+    rename(tmp_filepath.c_str(), filepath.c_str());
+}
+
+void write_registry_snapshot(const Str& filepath, const std::vector<u8>& data)
+{
+    write_file_replace(filepath, data.data(), data.size());
+}
+
+// delta registry sync. a full copy of each index is kept in <index>.sync.json, mapped from <index>.sync.snap,
+// with its watermarks in <index>.sync.meta: the highest scrape stamp ("updated", unix seconds from the scraper),
+// the highest like stamp ("likes/updated", server milliseconds written with each like count) and the time of
+// the last full sync. the first sync fetches the whole index, after that only the releases stamped since either
+// watermark are fetched and patched in. a delta carries the whole current release, so one without the index
+// key is a tombstone: it dropped out of the view and is removed. writes which don't stamp (a release deleted
+// outright, a manual patch) can't show up in a delta, the copy is fully synced every k_delta_full_sync_s so
+// they are picked up eventually
+struct SyncLocks
+{
+    std::mutex                          mutex;
+    std::map<std::string, std::mutex>   index;
+};
+SyncLocks s_sync_locks;
+
+// a delta doesn't depend on the index, one fetch serves every index synced in the same round.
+// a delta from start_at holds everything an index with a watermark >= start_at needs
+struct SyncDelta
+{
+    const c8*                               order_by;
+    std::mutex                              mutex;
+    unsigned long long                      start_at = 0;
+    std::chrono::steady_clock::time_point   fetched;
+    std::shared_ptr<const nlohmann::json>   json;
+};
+SyncDelta s_scrape_delta = { "updated" };
+SyncDelta s_likes_delta = { "likes/updated" };
+
+Str sync_filepath(const Str& index_on, const c8* ext)
+{
+    Str filename = index_on;
+    filename.appendf(".sync.%s", ext);
+    return get_persistent_filepath(filename.c_str(), true);
+}
+
+// a release's stamp at ptr, 0 if it has none
+unsigned long long release_stamp(const nlohmann::json& release, const nlohmann::json::json_pointer& ptr)
+{
+    if(!release.is_object() || !release.contains(ptr)) {
+        return 0;
+    }
+
+    auto& stamp = release.at(ptr);
+    return stamp.is_number() ? stamp.get<unsigned long long>() : 0;
+}
+
+// returns the releases stamped since watermark, reusing the last delta if it was fetched this round from
+// an older or equal watermark. null if the fetch failed
+std::shared_ptr<const nlohmann::json> fetch_registry_delta(SyncDelta& sync_delta, unsigned long long watermark)
+{
+    // held across the fetch so indices syncing at the same time wait for one request
+    std::lock_guard<std::mutex> lock(sync_delta.mutex);
+
+    auto now = std::chrono::steady_clock::now();
+    if(sync_delta.json && sync_delta.start_at <= watermark) {
+        if(std::chrono::duration<f64>(now - sync_delta.fetched).count() < k_delta_sync_round_s) {
+            return sync_delta.json;
+        }
+    }
+
+    // startAt is inclusive, releases stamped at the watermark come back and patch idempotently
+    Str url = curl::firebase_url("/releases.json");
+    url.appendf("?orderBy=\"%s\"&startAt=%llu&timeout=10s", sync_delta.order_by, watermark);
+    url = append_auth(url);
+
+    auto db = curl::download(url.c_str(), nullptr, nullptr, nullptr, TransferCategory::registry);
+    auto delta = std::make_shared<nlohmann::json>();
+    if(db.data) {
+        try {
+            *delta = nlohmann::json::parse((const c8*)db.data);
+        }
+        catch(...) {
+            //
+        }
+    }
+    curl::release_buffer(db);
+
+    // servers without the index reply with an error
+    if(!delta->is_object() || is_firebase_error(*delta)) {
+        return nullptr;
+    }
+
+    sync_delta.start_at = watermark;
+    sync_delta.fetched = now;
+    sync_delta.json = delta;
+    return delta;
+}
+
+// the newest stamp across the registry, a full sync starts its watermarks here so the first delta after it
+// doesn't fetch every release stamped since the epoch when the index itself holds no stamps. 0 if it failed
+unsigned long long fetch_latest_stamp(const SyncDelta& sync_delta, const nlohmann::json::json_pointer& ptr)
+{
+    Str url = curl::firebase_url("/releases.json");
+    url.appendf("?orderBy=\"%s\"&limitToLast=1&timeout=10s", sync_delta.order_by);
+    url = append_auth(url);
+
+    unsigned long long latest = 0;
+    auto db = curl::download(url.c_str(), nullptr, nullptr, nullptr, TransferCategory::registry);
+    if(db.data) {
+        try {
+            auto j = nlohmann::json::parse((const c8*)db.data);
+            if(j.is_object() && !is_firebase_error(j)) {
+                for(auto& item : j.items()) {
+                    latest = std::max(latest, release_stamp(item.value(), ptr));
                 }
             }
         }
         catch(...) {
-            async_dict.status = Status::e_not_initialised;
+            //
         }
-        async_dict.mutex.unlock();
     }
+    curl::release_buffer(db);
+    return latest;
+}
 
-    Str filepath = get_persistent_filepath(cache_filename, true);
-    if(async_dict.status == Status::e_ready)
-    {
-        // cache async
-        std::thread cache_thread([j, filepath]() {
-            FILE* fp = fopen(filepath.c_str(), "wb");
-            if(fp)
-            {
-                fwrite(j.data, j.size, 1, fp);
-                fclose(fp);
-                free(j.data); // cleanup
+// returns false if the index could not be synced, changed is set when the local copy was patched
+bool sync_registry_index(const Str& index_on, bool& changed)
+{
+    changed = false;
+
+    // views can sync the same index at the same time (a reload and a revalidate), one at a time per index
+    s_sync_locks.mutex.lock();
+    std::mutex& index_mutex = s_sync_locks.index[index_on.c_str()];
+    s_sync_locks.mutex.unlock();
+    std::lock_guard<std::mutex> lock(index_mutex);
+
+    auto tt = pen::scope_timer(index_on.c_str(), true);
+
+    Str json_filepath = sync_filepath(index_on, "json");
+    Str meta_filepath = sync_filepath(index_on, "meta");
+    Str snap_filepath = sync_filepath(index_on, "snap");
+
+    static const nlohmann::json::json_pointer scrape_stamp("/updated");
+    static const nlohmann::json::json_pointer likes_stamp("/likes/updated");
+
+    unsigned long long now = (unsigned long long)std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // local copy and its watermarks, without both or once the copy is due a full sync it's a full sync
+    nlohmann::json local;
+    unsigned long long watermark = 0;
+    unsigned long long likes_watermark = 0;
+    unsigned long long full_synced = 0;
+    bool full = true;
+    FILE* fp = fopen(meta_filepath.c_str(), "rb");
+    if(fp) {
+        if(fscanf(fp, "%llu %llu %llu", &watermark, &likes_watermark, &full_synced) == 3
+            && now < full_synced + (unsigned long long)k_delta_full_sync_s) {
+            try {
+                local = nlohmann::json::parse(std::ifstream(json_filepath.c_str()));
+                full = !local.is_object();
             }
-            else
-            {
-                PEN_LOG("failed to write: %s", filepath.c_str());
+            catch(...) {
+                // resync
             }
-        });
-        cache_thread.detach();
+        }
+        fclose(fp);
     }
-    else
-    {
-        // check for a cached item
-        u32 mtime = 0;
-        pen::filesystem_getmtime(filepath.c_str(), mtime);
-        if(mtime > 0) {
-            PEN_LOG("fallback to cache: %s", filepath.c_str());
 
-            // ensures it's valid
-            async_dict.mutex.lock();
+    if(full) {
+        // stamps are taken before the index is fetched, anything stamped in between comes back in the next delta
+        watermark = fetch_latest_stamp(s_scrape_delta, scrape_stamp);
+        likes_watermark = fetch_latest_stamp(s_likes_delta, likes_stamp);
+
+        Str url = curl::firebase_url("/releases.json");
+        url.appendf("?orderBy=\"%s\"&startAt=0&timeout=10s", index_on.c_str());
+        url = append_auth(url);
+
+        auto db = curl::download(url.c_str(), nullptr, nullptr, nullptr, TransferCategory::registry);
+        local = nlohmann::json();
+        if(db.data) {
             try {
-                async_dict.dict = nlohmann::json::parse(std::ifstream(filepath.c_str()));
-                async_dict.status = Status::e_ready;
-
-                // check for firebase errors
-                if(async_dict.dict.size() == 1) {
-                    for(auto& item : async_dict.dict.items()) {
-                        if(item.key() == "error") {
-                            PEN_LOG("cached error: %s", async_dict.dict.dump(4).c_str());
-                            async_dict.status = Status::e_not_initialised;
-                        }
-                    }
-                }
-            } catch (...) {
-                async_dict.status = Status::e_not_available;
+                local = nlohmann::json::parse((const c8*)db.data);
+            }
+            catch(...) {
+                //
             }
-            async_dict.mutex.unlock();
         }
-        else
-        {
-            PEN_LOG("no cache for: %s", filepath.c_str());
-            async_dict.status = Status::e_not_available;
+        curl::release_buffer(db);
+
+        if(!local.is_object() || is_firebase_error(local)) {
+            PEN_LOG("error: syncing %s", index_on.c_str());
+            return false;
         }
 
-        // cleanup
-        free(j.data);
+        for(auto& item : local.items()) {
+            watermark = std::max(watermark, release_stamp(item.value(), scrape_stamp));
+            likes_watermark = std::max(likes_watermark, release_stamp(item.value(), likes_stamp));
+        }
+        full_synced = now;
+        changed = true;
     }
+    else {
+        auto scrape_delta = fetch_registry_delta(s_scrape_delta, watermark);
+        auto likes_delta = fetch_registry_delta(s_likes_delta, likes_watermark);
+        if(!scrape_delta || !likes_delta) {
+            PEN_LOG("error: syncing %s", index_on.c_str());
+            return false;
+        }
 
-    return async_dict.status == Status::e_ready;
+        // a shared delta can start before this index's watermark, older stamps were already applied
+        auto apply = [&](const nlohmann::json& delta, const nlohmann::json::json_pointer& stamp, unsigned long long& mark) {
+            unsigned long long start_at = mark;
+            for(auto& item : delta.items()) {
+                auto& release = item.value();
+                unsigned long long updated = release_stamp(release, stamp);
+                if(updated == 0 || updated < start_at) {
+                    continue;
+                }
+                mark = std::max(mark, updated);
+
+                if(release.contains(index_on.c_str()) && release[index_on.c_str()].is_number()) {
+                    if(!local.contains(item.key()) || local[item.key()] != release) {
+                        local[item.key()] = release;
+                        changed = true;
+                    }
+                }
+                else if(local.contains(item.key())) {
+                    // tombstone
+                    local.erase(item.key());
+                    changed = true;
+                }
+            }
+        };
+
+        apply(*scrape_delta, scrape_stamp, watermark);
+        apply(*likes_delta, likes_stamp, likes_watermark);
+    }
+
+    if(changed) {
+        std::string j = local.dump();
+        write_file_replace(json_filepath, j.data(), j.size());
+
+        std::vector<u8> data;
+        build_registry_snapshot(local, index_on.c_str(), data);
+        write_registry_snapshot(snap_filepath, data);
+    }
+
+    // watermarks last, if anything above fails the next sync starts from the old ones
+    fp = fopen(meta_filepath.c_str(), "wb");
+    if(fp) {
+        fprintf(fp, "%llu %llu %llu\n", watermark, likes_watermark, full_synced);
+        fclose(fp);
+    }
+
+    PEN_LOG("synced %s: %s, watermarks %llu %llu", index_on.c_str(), full ? "full" : (changed ? "patched" : "current"),
+        watermark, likes_watermark);
+    return true;
+}
+
+// pre-connects to the firebase hosts and the asset cdns of every store (cdn_hosts in the cached stores.json),
+// started at launch so the handshakes happen while the ui is initialising
+void* connection_warm_up(void* userdata)
+{
+    auto tt = pen::scope_timer("connection_warm_up", true);
+
+    std::vector<Str> urls;
+    urls.push_back(curl::firebase_url("/"));
+    urls.push_back(curl::identity_url("/"));
+
+    try {
+        Str filepath = get_persistent_filepath("stores.json");
+        auto stores = nlohmann::json::parse(std::ifstream(filepath.c_str()));
+        for(auto& store : stores.items()) {
+            if(!store.value().contains("cdn_hosts")) {
+                continue;
+            }
+
+            for(auto& host : store.value()["cdn_hosts"]) {
+                Str url = "https://";
+                url.append(((std::string)host).c_str());
+                url.append("/");
+                urls.push_back(url);
+            }
+        }
+    }
+    catch(...) {
+        // first launch, no stores cached yet
+    }
+
+    curl::preconnect(urls);
+    return nullptr;
 }
 
 void* registry_loader(void* userdata)
 {
     DataContext* ctx = (DataContext*)userdata;
 
-    Str store_url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/stores.json?&timeout=5s";
+    Str store_url = curl::firebase_url("/stores.json?&timeout=5s");
     store_url = append_auth(store_url);
 
-    // fetch stores
+    // fetch stores, the cached config is served straight away and refreshed afterwards
     fetch_json_cache(
         store_url.c_str(),
         "stores.json",
-        ctx->stores
+        ctx->stores,
+        CachePolicy::stale_while_revalidate
     );
 
+    if(ctx->stores.stale)
+    {
+        AsyncDict fresh;
+        if(revalidate_json_cache(store_url.c_str(), "stores.json", fresh))
+        {
+            ctx->stores.mutex.lock();
+            ctx->stores.dict = std::move(fresh.dict);
+            ctx->stores.parsed = std::move(fresh.parsed);
+            ctx->stores.stale = false;
+            ctx->stores.mutex.unlock();
+        }
+    }
+
     return nullptr;
 };
 
@@ -828,8 +2876,8 @@ void* user_data_thread(void* userdata)
 
     Str userid = "";
     Str tokenid = "";
-    Str user_url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/users/";
-    Str likes_url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/likes.json";
+    Str user_url = curl::firebase_url("/users/");
+    Str likes_url = curl::firebase_url("/likes.json");
 
     nlohmann::json update_payload = {};
 
@@ -864,7 +2912,7 @@ void* user_data_thread(void* userdata)
                 // get all likes
                 CURLcode code;
 
-                Str url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/likes.json";
+                Str url = curl::firebase_url("/likes.json");
                 url.appendf("?auth=%s", tokenid.c_str());
 
                 auto global_likes = curl::request(
@@ -892,7 +2940,7 @@ void* user_data_thread(void* userdata)
                 url.appendf("%s.json", userid.c_str());
                 url.appendf("?auth=%s", tokenid.c_str());
 
-                curl::DataBuffer fetch = curl::download(url.c_str());
+                curl::DataBuffer fetch = curl::download(url.c_str(), nullptr, nullptr, nullptr, TransferCategory::user_data);
                 if(fetch.data)
                 {
                     try {
@@ -907,6 +2955,7 @@ void* user_data_thread(void* userdata)
                         // pass
                     }
                 }
+                curl::release_buffer(fetch);
 
                 fetch_cloud = false;
             }
@@ -934,263 +2983,765 @@ void* user_data_thread(void* userdata)
                         like_val = like.value() > 0.0f;
                     }
 
-                    Str like_path = "";
-                    like_path.appendf("%s/%s", like.key().c_str(), userid.c_str());
-                    likes_payload[like_path.c_str()] = (s32)like_val;
-                }
+                    Str like_path = "";
+                    like_path.appendf("%s/%s", like.key().c_str(), userid.c_str());
+                    likes_payload[like_path.c_str()] = (s32)like_val;
+                }
+
+                if(!likes_payload.empty()) {
+                    Str likes_patch_url = likes_url;
+                    likes_patch_url.appendf("?auth=%s", tokenid.c_str());
+
+                    std::string likes_payload_str = likes_payload.dump();
+
+                    CURLcode code;
+                    auto response = curl::patch(likes_patch_url.c_str(), likes_payload_str.c_str(), code);
+                }
+
+                update_cloud = false;
+            }
+        }
+
+        // if we have changes from the main thread, snapshot under the lock and write to disk outside it,
+        // so the main thread (likes / settings) never blocks behind file io
+        std::string user_data_str = "";
+        ctx->user_data.mutex.lock();
+        if(ctx->user_data.status == Status::e_invalidated) {
+            // timestamp for merges
+            ctx->user_data.dict["timestamp"] = get_like_timestamp_time();
+
+            user_data_str = ctx->user_data.dict.dump(4);
+
+            // and also update the cloud
+            update_payload = ctx->user_data.dict;
+            update_cloud = true;
+
+            ctx->user_data.status = Status::e_ready;
+        }
+        ctx->user_data.mutex.unlock();
+
+        if(!user_data_str.empty()) {
+            FILE* fp = fopen(user_data_filepath.c_str(), "w");
+            if(fp) {
+                fwrite(user_data_str.c_str(), user_data_str.length(), 1, fp);
+                fclose(fp);
+            }
+        }
+
+        pen::thread_sleep_ms(66);
+    }
+
+    return nullptr;
+}
+
+inline Str safe_discogs_str(nlohmann::json& j, const c8* key, const Str& default_value)
+{
+    if(j.contains("discogs"))
+    {
+        if(j["discogs"].contains(key))
+        {
+            return ((std::string)j["discogs"][key]).c_str();
+        }
+    }
+
+    return default_value;
+}
+
+inline Str safe_str(nlohmann::json& j, const c8* key, const Str& default_value)
+{
+    if(j.contains(key))
+    {
+        if(j[key].is_string())
+        {
+            return ((std::string)j[key]).c_str();
+        }
+    }
+
+    return default_value;
+}
+
+Str yt_video_id_from_url(const Str& url)
+{
+    // handles youtube.com/watch?v=<id> and youtu.be/<id> forms
+    const c8* start = nullptr;
+    const c8* s = url.c_str();
+
+    const c8* v = strstr(s, "?v=");
+    if(!v) {
+        v = strstr(s, "&v=");
+    }
+
+    if(v) {
+        start = v + 3;
+    }
+    else {
+        const c8* short_form = strstr(s, "youtu.be/");
+        if(short_form) {
+            start = short_form + strlen("youtu.be/");
+        }
+    }
+
+    if(!start) {
+        return "";
+    }
+
+    Str id = "";
+    for(const c8* c = start; *c; ++c) {
+        bool valid =
+            (*c >= 'a' && *c <= 'z') ||
+            (*c >= 'A' && *c <= 'Z') ||
+            (*c >= '0' && *c <= '9') ||
+            *c == '-' || *c == '_';
+
+        if(!valid) {
+            break;
+        }
+
+        id.append(*c);
+    }
+
+    return id;
+}
+
+// fetches releases by key into registry, returns the number found. firebase can't match a set of keys in
+// one query so the per key queries go out together as one batch rather than a round trip each
+size_t hydrate_releases(const std::vector<std::string>& keys, nlohmann::json& registry)
+{
+    std::vector<Str> urls;
+    urls.reserve(keys.size());
+    for(auto& key : keys) {
+        Str search_url = curl::firebase_url("/releases.json");
+        search_url.appendf("?orderBy=\"$key\"&equalTo=\"%s\"&timeout=1s", key.c_str());
+        urls.push_back(append_auth(search_url));
+    }
+
+    size_t found = 0;
+    auto results = curl::download_many(urls);
+    for(size_t i = 0; i < results.size(); ++i) {
+        if(results[i].data) {
+            try {
+                auto release = nlohmann::json::parse(results[i].data, results[i].data + results[i].size);
+                if(release.contains(keys[i]) && !release[keys[i]].is_null()) {
+                    registry[keys[i]] = std::move(release[keys[i]]);
+                    found++;
+                }
+            }
+            catch(...) {
+                //
+            }
+        }
+        curl::release_buffer(results[i]);
+    }
+
+    return found;
+}
+
+// liked keys with their timestamps, un-like tombstones are skipped
+std::vector<std::pair<std::string, f64>> get_liked_keys(const nlohmann::json& likes)
+{
+    std::vector<std::pair<std::string, f64>> liked;
+    for(auto& like : likes.items()) {
+        // like value might be bool or number
+        bool like_true = false;
+        f64 timestamp = 0.0;
+        if(like.value().is_boolean()) {
+            like_true = like.value();
+        }
+        else if(like.value().is_number()) {
+            // 0 is an un-like tombstone
+            like_true = like.value() > 0.0;
+            timestamp = like.value();
+        }
+
+        if(like_true) {
+            liked.push_back({like.key(), timestamp});
+        }
+    }
+    return liked;
+}
+
+// likes_feed.json is the compacted likes registry and likes_feed.log an append only journal on top of it, one
+// json record per line: {"add": key, "release": {...}} or {"remove": key}. a single writer thread owns both
+// files, a like or un-like appends one record and the journal is folded into the registry every
+// k_likes_journal_compact_records records. readers load the registry and replay the journal
+constexpr u32 k_likes_journal_compact_records = 64;
+constexpr u32 k_likes_journal_retry_s = 5;
+
+namespace LikesJournalOp
+{
+    enum LikesJournalOp
+    {
+        add,
+        remove
+    };
+}
+typedef u32 LikesJournalOp_t;
+
+struct LikesJournalRecord
+{
+    LikesJournalOp_t    op;
+    std::string         key;
+    nlohmann::json      release;
+};
+
+struct LikesJournal
+{
+    std::mutex                      mutex;
+    std::condition_variable         cv;
+    std::vector<LikesJournalRecord> queue;
+    bool                            started = false;
+    std::mutex                      files_mutex; // held while the writer touches the files and while readers load them
+};
+LikesJournal s_likes_journal;
+
+// replays the journal onto registry, a torn final record from an interrupted append is dropped and so are
+// add records without a release
+u32 replay_likes_journal(const Str& log_filepath, nlohmann::json& registry)
+{
+    std::ifstream log(log_filepath.c_str());
+    if(!log) {
+        return 0;
+    }
+
+    u32 count = 0;
+    std::string line;
+    while(std::getline(log, line)) {
+        try {
+            auto record = nlohmann::json::parse(line);
+            if(record.contains("add") && record["add"].is_string()) {
+                auto release = record.find("release");
+                if(release == record.end()) {
+                    continue;
+                }
+                registry[record["add"].get<std::string>()] = std::move(*release);
+            }
+            else if(record.contains("remove") && record["remove"].is_string() && registry.is_object()) {
+                registry.erase(record["remove"].get<std::string>());
+            }
+            count++;
+        }
+        catch(...) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+nlohmann::json load_likes_registry_files(const Str& filepath, const Str& log_filepath, u32* records = nullptr)
+{
+    auto registry = nlohmann::json::object();
+    try {
+        registry = nlohmann::json::parse(std::ifstream(filepath.c_str()));
+    }
+    catch(...) {
+        // ..
+    }
+
+    if(!registry.is_object()) {
+        registry = nlohmann::json::object();
+    }
+
+    u32 count = replay_likes_journal(log_filepath, registry);
+    if(records) {
+        *records = count;
+    }
+    return registry;
+}
 
-                if(!likes_payload.empty()) {
-                    Str likes_patch_url = likes_url;
-                    likes_patch_url.appendf("?auth=%s", tokenid.c_str());
+// writes the registry and then drops the journal. a crash in between replays records already in the registry,
+// which are absolute so that is harmless
+void compact_likes_registry(const Str& filepath, const Str& log_filepath, const nlohmann::json& registry)
+{
+    std::string j = registry.dump();
+    write_file_replace(filepath, j.data(), j.size());
+    remove(log_filepath.c_str());
+}
 
-                    std::string likes_payload_str = likes_payload.dump();
+void likes_journal_writer()
+{
+    Str filepath = get_persistent_filepath("likes_feed.json", true);
+    Str log_filepath = get_persistent_filepath("likes_feed.log", true);
 
-                    CURLcode code;
-                    auto response = curl::patch(likes_patch_url.c_str(), likes_payload_str.c_str(), code);
-                }
+    // fold in the records left from last time, this also drops a torn final record which later appends
+    // would otherwise run into
+    u32 records = 0;
+    s_likes_journal.files_mutex.lock();
+    u32 mtime = 0;
+    pen::filesystem_getmtime(log_filepath.c_str(), mtime);
+    if(mtime != 0) {
+        auto registry = load_likes_registry_files(filepath, log_filepath);
+        compact_likes_registry(filepath, log_filepath, registry);
+    }
+    s_likes_journal.files_mutex.unlock();
 
-                update_cloud = false;
+    std::vector<LikesJournalRecord> pending;
+    size_t requeued = 0;
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(s_likes_journal.mutex);
+
+            // records put back after a failed write go again once more arrive, or after a while
+            if(requeued > 0) {
+                s_likes_journal.cv.wait_for(lock, std::chrono::seconds(k_likes_journal_retry_s), [requeued]() {
+                    return s_likes_journal.queue.size() > requeued;
+                });
             }
+            s_likes_journal.cv.wait(lock, []() { return !s_likes_journal.queue.empty(); });
         }
+        requeued = 0;
 
-        // if we have changes from the main thread, snapshot under the lock and write to disk outside it,
-        // so the main thread (likes / settings) never blocks behind file io
-        std::string user_data_str = "";
-        ctx->user_data.mutex.lock();
-        if(ctx->user_data.status == Status::e_invalidated) {
-            // timestamp for merges
-            ctx->user_data.dict["timestamp"] = get_like_timestamp_time();
+        // the files are taken before the queue is drained, so a reader holding them sees every record
+        // either written or still queued
+        std::lock_guard<std::mutex> files_lock(s_likes_journal.files_mutex);
+        s_likes_journal.mutex.lock();
+        pending.swap(s_likes_journal.queue);
+        s_likes_journal.mutex.unlock();
 
-            user_data_str = ctx->user_data.dict.dump(4);
+        FILE* log = nullptr;
+        for(size_t i = 0; i < pending.size(); ++i)
+        {
+            auto& record = pending[i];
+            if(!log) {
+                log = fopen(log_filepath.c_str(), "ab");
+                if(!log) {
+                    // keep the unwritten records queued ahead of anything pushed since, in order
+                    PEN_LOG("failed to write: %s", log_filepath.c_str());
+                    s_likes_journal.mutex.lock();
+                    auto& queue = s_likes_journal.queue;
+                    queue.insert(queue.begin(), std::make_move_iterator(pending.begin() + i), std::make_move_iterator(pending.end()));
+                    requeued = queue.size();
+                    s_likes_journal.mutex.unlock();
+                    break;
+                }
+            }
 
-            // and also update the cloud
-            update_payload = ctx->user_data.dict;
-            update_cloud = true;
+            nlohmann::json entry;
+            if(record.op == LikesJournalOp::add) {
+                entry = {{"add", record.key}, {"release", std::move(record.release)}};
+            }
+            else {
+                entry = {{"remove", record.key}};
+            }
 
-            ctx->user_data.status = Status::e_ready;
+            std::string line = entry.dump();
+            line.push_back('\n');
+            fwrite(line.data(), line.size(), 1, log);
+            records++;
         }
-        ctx->user_data.mutex.unlock();
 
-        if(!user_data_str.empty()) {
-            FILE* fp = fopen(user_data_filepath.c_str(), "w");
-            if(fp) {
-                fwrite(user_data_str.c_str(), user_data_str.length(), 1, fp);
-                fclose(fp);
-            }
+        if(log) {
+            fclose(log);
         }
+        pending.clear();
 
-        pen::thread_sleep_ms(66);
+        if(records >= k_likes_journal_compact_records)
+        {
+            auto registry = load_likes_registry_files(filepath, log_filepath);
+            compact_likes_registry(filepath, log_filepath, registry);
+            PEN_LOG("compacted likes journal: %u records", records);
+            records = 0;
+        }
     }
-
-    return nullptr;
 }
 
-inline Str safe_discogs_str(nlohmann::json& j, const c8* key, const Str& default_value)
+void likes_journal_push(LikesJournalRecord&& record)
 {
-    if(j.contains("discogs"))
-    {
-        if(j["discogs"].contains(key))
-        {
-            return ((std::string)j["discogs"][key]).c_str();
-        }
+    std::lock_guard<std::mutex> lock(s_likes_journal.mutex);
+    if(!s_likes_journal.started) {
+        std::thread writer(likes_journal_writer);
+        writer.detach();
+        s_likes_journal.started = true;
     }
 
-    return default_value;
+    s_likes_journal.queue.push_back(std::move(record));
+    s_likes_journal.cv.notify_one();
 }
 
-inline Str safe_str(nlohmann::json& j, const c8* key, const Str& default_value)
+void likes_journal_add(const std::string& key, nlohmann::json release)
 {
-    if(j.contains(key))
-    {
-        if(j[key].is_string())
-        {
-            return ((std::string)j[key]).c_str();
-        }
-    }
+    likes_journal_push({LikesJournalOp::add, key, std::move(release)});
+}
 
-    return default_value;
+void likes_journal_remove(const std::string& key)
+{
+    likes_journal_push({LikesJournalOp::remove, key, nullptr});
 }
 
-Str yt_video_id_from_url(const Str& url)
+// the likes registry as of the last record pushed, records still queued for the writer are applied on top
+nlohmann::json load_likes_registry()
 {
-    // handles youtube.com/watch?v=<id> and youtu.be/<id> forms
-    const c8* start = nullptr;
-    const c8* s = url.c_str();
+    Str filepath = get_persistent_filepath("likes_feed.json", true);
+    Str log_filepath = get_persistent_filepath("likes_feed.log", true);
 
-    const c8* v = strstr(s, "?v=");
-    if(!v) {
-        v = strstr(s, "&v=");
-    }
+    std::lock_guard<std::mutex> files_lock(s_likes_journal.files_mutex);
+    auto registry = load_likes_registry_files(filepath, log_filepath);
 
-    if(v) {
-        start = v + 3;
-    }
-    else {
-        const c8* short_form = strstr(s, "youtu.be/");
-        if(short_form) {
-            start = short_form + strlen("youtu.be/");
+    std::lock_guard<std::mutex> lock(s_likes_journal.mutex);
+    for(auto& record : s_likes_journal.queue)
+    {
+        if(record.op == LikesJournalOp::add) {
+            registry[record.key] = record.release;
         }
-    }
-
-    if(!start) {
-        return "";
-    }
-
-    Str id = "";
-    for(const c8* c = start; *c; ++c) {
-        bool valid =
-            (*c >= 'a' && *c <= 'z') ||
-            (*c >= 'A' && *c <= 'Z') ||
-            (*c >= '0' && *c <= '9') ||
-            *c == '-' || *c == '_';
-
-        if(!valid) {
-            break;
+        else {
+            registry.erase(record.key);
         }
-
-        id.append(*c);
     }
 
-    return id;
+    return registry;
 }
 
 void update_likes_registry() {
     // kick off a job to update the likes cache, (get up-to-date out of stock info etc)
     std::thread cache_thread([]() {
-        auto update_likes_registry = nlohmann::json();
-        auto likes = get_likes();
-        for(auto& like : likes.items()) {
-            // like value might be bool or number
-            bool like_true = false;
-            f32 timestamp = 0.0f;
-            if(like.value().is_boolean()) {
-                like_true = like.value();
-            }
-            else if(like.value().is_number()) {
-                // 0 is an un-like tombstone
-                like_true = like.value() > 0.0f;
-                timestamp = like.value();
-            }
-
-            if(like_true) {
-                Str search_url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/releases.json";
-                search_url.appendf("?orderBy=\"$key\"&equalTo=\"%s\"&timeout=1s", like.key().c_str());
-                search_url = append_auth(search_url);
-
-                auto db = curl::download(search_url.c_str());
-                if(db.data)
-                {
-                    nlohmann::json release;
-                    try {
-                        release = nlohmann::json::parse(db.data);
-                        update_likes_registry[like.key()] = release[like.key()];
-                    }
-                    catch(...) {
-                        //
-                    }
-                    free(db.data);
-                }
-                else {
-                }
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::string> keys;
+        for(auto& like : get_liked_keys(get_likes())) {
+            keys.push_back(like.first);
+        }
+
+        auto update_likes_registry = nlohmann::json::object();
+        size_t found = hydrate_releases(keys, update_likes_registry);
+
+        // one add per refreshed release rather than replacing the registry, so likes made while this ran
+        // and releases which failed to fetch keep what the registry has. keys un-liked meanwhile are not
+        // added back
+        std::set<std::string> liked;
+        for(auto& like : get_liked_keys(get_likes())) {
+            liked.insert(like.first);
+        }
+
+        for(auto& release : update_likes_registry.items()) {
+            if(liked.find(release.key()) != liked.end()) {
+                likes_journal_add(release.key(), std::move(release.value()));
             }
         }
 
-        // write to disk
-        PEN_LOG("updated likes registry");
-        Str filepath = get_persistent_filepath("likes_feed.json", true);
-        FILE* fp = fopen(filepath.c_str(), "wb");
-        std::string j = update_likes_registry.dump();
-        fwrite(j.c_str(), j.length(), 1, fp);
-        fclose(fp);
+        f32 ms = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - start).count();
+        PEN_LOG("updated likes registry: %zu / %zu in %.1fms", found, keys.size(), ms);
     });
     cache_thread.detach();
 }
 
+// grows the soa so count more entries fit after the published ones. nothing reads the columns until the
+// first entry is published so the first grow happens here, after that the soa readers park and the main
+// thread reallocs in grow_views. returns false if the view was terminated while waiting
+bool grow_view_releases(ReleasesView* view, size_t count)
+{
+    size_t spare = view->releases.soa_size - view->releases.available_entries;
+    if(count <= spare) {
+        return true;
+    }
+
+    if(view->releases.available_entries == 0) {
+        resize_components(view->releases, count - spare);
+        return true;
+    }
+
+    // wait for the readers to leave the parking loop too, so a new request can't catch one on its way out
+    std::unique_lock<std::mutex> lock(view->grow_mutex);
+    view->grow_size = count - spare;
+    view->grow_cv.wait(lock, [view]() {
+        return (!view->grow_size && !view->readers_parked) || view->terminate;
+    });
+
+    return !view->terminate;
+}
+
+// soa readers call this at the top of their loop to hold off while the columns are reallocated
+void park_for_view_growth(ReleasesView* view)
+{
+    if(!view->grow_size) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(view->grow_mutex);
+    view->readers_parked++;
+    view->grow_cv.wait(lock, [view]() {
+        return !view->grow_size || view->terminate;
+    });
+    view->readers_parked--;
+
+    // the loader waits for the readers to leave
+    view->grow_cv.notify_all();
+}
+
+struct StaleSection
+{
+    Str url;
+    Str cache_file;
+    Str snapshot_filepath;
+    Str index_on;
+};
+
+struct FeedSection
+{
+    Str                     index_on;
+    f64                     last_pos = 0.0; // highest chart position fetched so far
+    u32                     page = 0;
+    bool                    exhausted = false;
+    const RegistrySnapshot* synced = nullptr; // local copy of the whole index when delta syncing
+    u32                     next_record = 0;
+    bool                    needs_sync = false;
+    bool                    is_stale = false; // first page was served from cache, stale holds what to revalidate
+    StaleSection            stale;
+};
+
 void* releases_view_loader(void* userdata)
 {
     // get view from userdata
     ReleasesView* view = (ReleasesView*)userdata;
     auto& store_view = view->store_view;
+    auto load_start = std::chrono::steady_clock::now();
 
     nlohmann::json releases_registry;
     std::vector<ChartItem> view_chart;
 
-    // track added items to avoid duplicates that appear in multiple genre sections
-    std::map<std::string, size_t> added_map;
+    // track added items to avoid duplicates that appear in multiple genre sections, view_chart index by key hash
+    FlatHashMap<size_t> added_map;
 
-    if(view->page == Page::feed) {
-        for(auto& section : store_view.selected_sections) {
+    // sections served from cache, which are refreshed once the view is populated
+    std::vector<StaleSection> stale_sections;
 
-            // index is concantonated store-section-view.json
-            Str index_on = "";
-            index_on.appendf(
-                "%s-%s-%s",
-                store_view.store_name.c_str(),
-                section.c_str(),
-                store_view.selected_view.c_str()
-            );
+    // pages are populated from snapshots owned by the view, the soa text columns point into them
+    auto& snapshots = view->snapshots;
+
+    // feed sections are queried a page at a time in chart order, further pages are fetched as the user
+    // scrolls towards the end of what has been published
+    std::vector<FeedSection> sections;
+    std::vector<size_t> pending;
+    std::mutex merge_mutex;
+
+    // merges snapshot records [first, end) into the chart, call with merge_mutex held
+    auto merge_records = [&](const RegistrySnapshot& snapshot, u32 first, u32 end) {
+        view->release_pos_mutex.lock();
+        for(u32 r = first; r < end; ++r)
+        {
+            const SnapshotRecord& record = snapshot.records[r];
+            u64 hh = hash64(snapshot.str(record.key), record.key.length);
 
-            // cache file is the index name saved as json
-            Str cache_file = index_on;
-            cache_file.append(".json");
+            size_t* added = added_map.find(hh);
+            if(added) {
+                // if already in map, update using the min chart pos
+                auto vp = *added;
+                view_chart[vp].pos = std::min<u32>((u32)record.pos, (u32)view_chart[vp].pos);
 
-            // ordered search
-            Str search_url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/releases.json";
-            search_url.appendf("?orderBy=\"%s\"&startAt=0&timeout=10s", index_on.c_str());
-            search_url = append_auth(search_url);
+                // update map pos
+                view->release_pos[hh] = view_chart[vp].pos;
+            }
+            else {
+                // add new entry to view_chart
+                added_map.insert(hh, view_chart.size());
+
+                pending.push_back(view_chart.size());
+
+                view_chart.push_back({
+                    snapshot.str(record.key),
+                    record.pos,
+                    &snapshot,
+                    r
+                });
+
+                // insert hashed
+                view->release_pos.insert(hh, (u32)record.pos);
+            }
+        }
+        view->release_pos_mutex.unlock();
+    };
+
+    auto fetch_page = [&](FeedSection& section) -> bool {
+        // synced sections page through the local copy of the index instead of the network
+        if(section.synced) {
+            merge_mutex.lock();
+            u32 record_count = section.synced->header->record_count;
+            u32 first = section.next_record;
+            u32 end = std::min<u32>(first + k_feed_page_size, record_count);
+            merge_records(*section.synced, first, end);
+
+            if(end > first) {
+                section.last_pos = std::max<f64>(section.last_pos, section.synced->records[end - 1].pos);
+            }
+            section.next_record = end;
+            section.exhausted = (end == record_count);
+            section.page++;
+            merge_mutex.unlock();
+            return true;
+        }
+
+        // startAt is inclusive so each page overlaps the last by an entry, the overlap dedupes below
+        Str search_url = curl::firebase_url("/releases.json");
+        search_url.appendf(
+            "?orderBy=\"%s\"&startAt=%u&limitToFirst=%u&timeout=10s",
+            section.index_on.c_str(),
+            (u32)section.last_pos,
+            k_feed_page_size
+        );
+        search_url = append_auth(search_url);
 
-            AsyncDict async_registry;
-            fetch_json_cache(
+        // cache file is the index name saved as json, the first page is served stale while revalidating
+        Str cache_name = section.index_on;
+        CachePolicy_t policy = view->cache_policy;
+        if(section.page > 0) {
+            cache_name.appendf(".p%u", section.page);
+            policy = CachePolicy::network_first;
+        }
+
+        Str cache_file = cache_name;
+        cache_file.append(".json");
+
+        Str snapshot_file = cache_name;
+        snapshot_file.append(".snap");
+        Str snapshot_filepath = get_persistent_filepath(snapshot_file.c_str(), true);
+
+        merge_mutex.lock();
+        snapshots.emplace_back();
+        RegistrySnapshot& snapshot = snapshots.back();
+        merge_mutex.unlock();
+
+        // a cached page maps its snapshot rather than parsing the json
+        bool stale = false;
+        bool mapped = false;
+        if(policy != CachePolicy::network_first) {
+            mapped = map_registry_snapshot(snapshot_filepath, snapshot);
+            stale = mapped && (policy == CachePolicy::stale_while_revalidate);
+        }
+
+        if(!mapped) {
+            bool fetched = fetch_registry_snapshot(
                 search_url.c_str(),
                 cache_file.c_str(),
-                async_registry
+                snapshot_filepath,
+                section.index_on.c_str(),
+                snapshot.buffer,
+                policy,
+                stale
             );
 
-            // TODO: handle total failure case
-            if(async_registry.status != Status::e_ready)
-            {
-                PEN_LOG("error: fetching %s", index_on.c_str());
-                view->status = Status::e_not_available;
-                view->threads_terminated++;
-                return nullptr;
+            if(!fetched) {
+                PEN_LOG("error: fetching %s page %u", section.index_on.c_str(), section.page);
+                return false;
             }
 
-            // add stored?
-            for(auto& item : async_registry.dict.items())
-            {
-                auto val = item.value();
+            // snapshot the page for the next load
+            fixup_registry_snapshot(snapshot, snapshot.buffer.data(), snapshot.buffer.size());
+            write_registry_snapshot(snapshot_filepath, snapshot.buffer);
+        }
 
-                if(added_map.find(item.key()) != added_map.end()) {
-                    // if already in map, update using the min chart pos
-                    auto vp = added_map[item.key()];
-                    view_chart[vp].pos = std::min<u32>((u32)val[index_on.c_str()], (u32)view_chart[vp].pos);
+        // sections fetch concurrently and merge as they complete
+        merge_mutex.lock();
 
-                    // update map pos
-                    u32 hh = PEN_HASH(item.key().c_str());
-                    view->release_pos[hh] = view_chart[vp].pos;
-                }
-                else {
-                    // add new entry to view_chart
-                    added_map.insert({
-                        item.key(),
-                        view_chart.size()
-                    });
+        if(stale) {
+            section.is_stale = true;
+            section.stale = {search_url, cache_file, snapshot_filepath, section.index_on};
+        }
+
+        // add stored? records are sorted by chart position
+        f64 prev_last_pos = section.last_pos;
+        u32 record_count = snapshot.header->record_count;
+        if(record_count > 0) {
+            section.last_pos = std::max<f64>(section.last_pos, snapshot.records[record_count - 1].pos);
+        }
 
-                    view_chart.push_back({
-                        item.key(),
-                        val[index_on.c_str()]
-                    });
+        merge_records(snapshot, 0, record_count);
 
-                    // insert hashed
-                    u32 hh = PEN_HASH(item.key().c_str());
-                    view->release_pos.insert({
-                        hh,
-                        val[index_on.c_str()]
-                    });
+        // a short page is the end of the section, so is a page which didn't move past the last one
+        if(record_count < k_feed_page_size || (section.page > 0 && section.last_pos <= prev_last_pos)) {
+            section.exhausted = true;
+        }
+        section.page++;
+
+        merge_mutex.unlock();
+        return true;
+    };
+
+    // with delta sync a section pages through its local copy of the index. a reload syncs before mapping
+    // it, otherwise the copy is mapped as it is and synced once the view has been populated. sections with
+    // no local copy yet page from the network and get their first full sync then
+    auto open_synced_section = [&](FeedSection& section) {
+        bool synced = false;
+        if(view->cache_policy == CachePolicy::network_first) {
+            bool changed = false;
+            synced = sync_registry_index(section.index_on, changed);
+        }
+
+        merge_mutex.lock();
+        snapshots.emplace_back();
+        RegistrySnapshot& snapshot = snapshots.back();
+        merge_mutex.unlock();
+
+        if(map_registry_snapshot(sync_filepath(section.index_on, "snap"), snapshot)) {
+            section.synced = &snapshot;
+        }
+
+        section.needs_sync = !synced && view->cache_policy != CachePolicy::cache_only;
+    };
+
+    // entries up to the lowest last position of the sections with more pages can't be preceded by
+    // anything fetched later, so they are final and safe to publish in order
+    auto publish_watermark = [&]() {
+        f64 watermark = DBL_MAX;
+        for(auto& section : sections) {
+            if(!section.exhausted) {
+                watermark = std::min(watermark, section.last_pos);
+            }
+        }
+        return watermark;
+    };
+
+    if(view->page == Page::feed) {
+        for(auto& section : store_view.selected_sections) {
+
+            // index is concantonated store-section-view.json
+            FeedSection feed_section;
+            feed_section.index_on.appendf(
+                "%s-%s-%s",
+                store_view.store_name.c_str(),
+                section.c_str(),
+                store_view.selected_view.c_str()
+            );
+
+            sections.push_back(feed_section);
+        }
+
+        // first pages are fetched in parallel so the view waits on the slowest section, not the sum of them.
+        // each thread gets its own section and result slot, merging into the view goes through merge_mutex
+        std::vector<u8> fetched(sections.size(), 0);
+        std::vector<std::thread> fetches;
+        for(size_t i = 0; i < sections.size(); ++i) {
+            FeedSection* section = &sections[i];
+            u8* result = &fetched[i];
+            fetches.push_back(std::thread([section, result, &fetch_page, &open_synced_section]() {
+                if(k_delta_registry_sync) {
+                    open_synced_section(*section);
                 }
+                *result = fetch_page(*section) ? 1 : 0;
+            }));
+        }
+
+        for(auto& fetch : fetches) {
+            fetch.join();
+        }
+
+        // a failed section is left out, it would otherwise hold the publish watermark at its start
+        size_t failed = 0;
+        for(size_t i = 0; i < sections.size(); ++i) {
+            if(!fetched[i]) {
+                sections[i].exhausted = true;
+                failed++;
             }
+            else if(sections[i].is_stale) {
+                stale_sections.push_back(sections[i].stale);
+            }
+        }
 
-            releases_registry.merge_patch(async_registry.dict);
+        // the view is only unavailable when no section could be fetched
+        if(failed == sections.size())
+        {
+            view->status = Status::e_not_available;
+            view->threads_terminated++;
+            return nullptr;
         }
     }
     else if(view->page == Page::discogs) {
@@ -1207,14 +3758,11 @@ void* releases_view_loader(void* userdata)
         Str search_url = discogs_build_search_url();
 
         long http_code = 0;
-        auto search = curl::discogs_request("GET", search_url.c_str(), token.c_str(), nullptr, &http_code);
+        auto search = curl::discogs_request("GET", search_url.c_str(), token.c_str(), nullptr, &http_code, &view->terminate);
 
         if(http_code == 429) {
-            // rate limited: cool off once and retry
-            for(u32 s = 0; s < 80 && !view->terminate; ++s) {
-                pen::thread_sleep_ms(100);
-            }
-            search = curl::discogs_request("GET", search_url.c_str(), token.c_str(), nullptr, &http_code);
+            // rate limited: the limiter holds the retry until there is budget again
+            search = curl::discogs_request("GET", search_url.c_str(), token.c_str(), nullptr, &http_code, &view->terminate);
         }
 
         if(http_code != 200 || !search.contains("results")) {
@@ -1316,7 +3864,7 @@ void* releases_view_loader(void* userdata)
             }
 
             std::string key = "discogs-" + std::to_string(id);
-            releases_registry[key] = release;
+            releases_registry[key] = std::move(release);
 
             view_chart.push_back({
                 key,
@@ -1327,98 +3875,60 @@ void* releases_view_loader(void* userdata)
     else {
 
         // look in cache
-        Str filepath = get_persistent_filepath("likes_feed.json", true);
-        auto likes_registry = nlohmann::json();
-        try {
-            likes_registry = nlohmann::json::parse(std::ifstream(filepath.c_str()));
+        auto likes_registry = load_likes_registry();
 
-        } catch (...) {
-            // ..
-        }
-
-        auto likes = get_likes();
+        auto liked = get_liked_keys(get_likes());
 
         // populate from cache where possible and only fetch releases which are
         // missing, so adding a single new like does not refetch the whole feed
-        bool fetched_missing = false;
-        for(auto& like : likes.items()) {
-
-            // like value might be bool or number
-            bool like_true = false;
-            f64 timestamp = 0.0f;
-            if(like.value().is_boolean()) {
-                like_true = like.value();
-            }
-            else if(like.value().is_number()) {
-                // 0 is an un-like tombstone
-                like_true = like.value() > 0.0;
-                timestamp = like.value();
+        std::vector<std::string> missing;
+        for(auto& like : liked) {
+            // use cached release info if we have it
+            if(likes_registry.contains(like.first) && !likes_registry[like.first].is_null()) {
+                releases_registry[like.first] = std::move(likes_registry[like.first]);
             }
-
-            if(!like_true) {
-                continue;
+            else {
+                missing.push_back(like.first);
             }
+        }
 
-            // use cached release info if we have it
-            if(likes_registry.contains(like.key()) && !likes_registry[like.key()].is_null()) {
-                releases_registry[like.key()] = likes_registry[like.key()];
+        // fetch missing release info as one batch
+        bool fetched_missing = false;
+        if(!missing.empty()) {
+            PEN_LOG("fetch missing likes: %zu", missing.size());
+            fetched_missing = hydrate_releases(missing, releases_registry) > 0;
+        }
 
+        for(auto& like : liked) {
+            if(releases_registry.contains(like.first)) {
                 view_chart.push_back({
-                    like.key(),
-                    timestamp
+                    like.first,
+                    like.second
                 });
-                continue;
             }
+        }
 
-            // fetch missing release info
-            PEN_LOG("fetch missing like: %s", like.key().c_str());
-            Str search_url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/releases.json";
-            search_url.appendf("?orderBy=\"$key\"&equalTo=\"%s\"&timeout=1s", like.key().c_str());
-            search_url = append_auth(search_url);
+        // journal what we fetched and the releases which were un-liked, rather than rewriting the registry.
+        // releases_registry is rebuilt from liked keys only, so entries it doesn't have were un-liked
+        bool pruned = false;
+        for(auto& item : likes_registry.items()) {
+            if(!releases_registry.contains(item.key())) {
+                likes_journal_remove(item.key());
+                pruned = true;
+            }
+        }
 
-            auto db = curl::download(search_url.c_str());
-            if(db.data)
-            {
-                nlohmann::json release;
-                try {
-                    release = nlohmann::json::parse(db.data);
-                    if(release.contains(like.key()) && !release[like.key()].is_null()) {
-                        releases_registry[like.key()] = release[like.key()];
-                        fetched_missing = true;
-
-                        view_chart.push_back({
-                            like.key(),
-                            timestamp
-                        });
-                    }
-                }
-                catch(...) {
-                    //
+        if(fetched_missing) {
+            for(auto& key : missing) {
+                if(releases_registry.contains(key)) {
+                    likes_journal_add(key, releases_registry[key]);
                 }
-
-                free(db.data);
-            }
-            else {
             }
         }
 
-        // write to cache if we fetched anything new or pruned removed likes.
-        // releases_registry is rebuilt from liked keys only, so entries for
-        // un-liked releases drop out here
-        if(fetched_missing || releases_registry.size() != likes_registry.size())
+        if(fetched_missing || pruned)
         {
             PEN_LOG("caching likes registry");
-
-            // cache async
-            std::thread cache_thread([releases_registry, filepath]() {
-                FILE* fp = fopen(filepath.c_str(), "wb");
-                if(fp) {
-                    std::string j = releases_registry.dump();
-                    fwrite(j.c_str(), j.length(), 1, fp);
-                    fclose(fp);
-                }
-            });
-            cache_thread.detach();
         }
         else {
             // trigger a background refresh of the cache (up-to-date out of stock info etc)
@@ -1429,20 +3939,14 @@ void* releases_view_loader(void* userdata)
         if(view_chart.size() == 0)
         {
             // look in cache
-            try {
-                releases_registry = nlohmann::json::parse(std::ifstream(filepath.c_str()));
+            releases_registry = load_likes_registry();
 
-                // add to view chart
-                for(auto& item : releases_registry.items()) {
-                    view_chart.push_back({
-                        item.key(),
-                        0
-                    });
-                }
-
-            }
-            catch (...) {
-                view->status = Status::e_not_available;
+            // add to view chart
+            for(auto& item : releases_registry.items()) {
+                view_chart.push_back({
+                    item.key(),
+                    0
+                });
             }
         }
     }
@@ -1457,51 +3961,33 @@ void* releases_view_loader(void* userdata)
     // view is ready to cleanup
     view->release_pos_status = Status::e_ready;
 
-    // sort the items
-    if(view->page == Page::likes) {
-        // likes are sorted descending by timestamp
-        std::sort(begin(view_chart),end(view_chart),[](ChartItem a, ChartItem b) {return a.pos > b.pos; });
-    }
-    else {
-        // feed is sorted ascending by position
-        std::sort(begin(view_chart),end(view_chart),[](ChartItem a, ChartItem b) {return a.pos < b.pos; });
-    }
-
-    // make space
-    resize_components(view->releases, view_chart.size());
+    Str likes_url = curl::firebase_url("/likes/");
 
-    Str likes_url = "https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/likes/";
-
-    for(auto& entry : view_chart)
+    // populates the next soa entry from a snapshot record, the strings point straight into the string table
+    auto populate = [&](const ChartItem& entry, u32 ri) -> bool
     {
-        u32 ri = (u32)view->releases.available_entries;
-        auto release = releases_registry[entry.index];
-        
         // skip null (from removed like?)
-        if(release.is_null())
-            continue;
+        if(!entry.snapshot)
+            return false;
+
+        const RegistrySnapshot& snapshot = *entry.snapshot;
+        const SnapshotRecord& release = snapshot.records[entry.record];
 
         // simple info
-        view->releases.artist[ri] = safe_str(release, "artist", "");
-        view->releases.title[ri] = safe_str(release, "title", "");
-        view->releases.link[ri] = safe_str(release, "link", "");
-        view->releases.label[ri] = safe_str(release, "label", "");
-        view->releases.cat[ri] = safe_str(release, "cat", "");
-        view->releases.store[ri] = safe_str(release, "store", "");
-        view->releases.label_link[ri] = safe_str(release, "label_link", "");
-        
+        view->releases.artist[ri] = snapshot.view(release.artist);
+        view->releases.title[ri] = snapshot.view(release.title);
+        view->releases.link[ri] = snapshot.view(release.link);
+        view->releases.label[ri] = snapshot.view(release.label);
+        view->releases.cat[ri] = snapshot.view(release.cat);
+        view->releases.store[ri] = snapshot.view(release.store);
+        view->releases.label_link[ri] = snapshot.view(release.label_link);
+
         // likes
-        view->releases.like_count[ri] = 0;
-        if (release.contains("likes") && release["likes"].contains("count")) {
-            view->releases.like_count[ri] = release["likes"]["count"].get<int>();
-        }
+        view->releases.like_count[ri] = release.like_count;
 
         // discogs info
-        view->releases.discogs_url[ri] = safe_discogs_str(release, "url", "");
-        view->releases.discogs_id[ri] = -1;
-        if (release.contains("discogs") && release["discogs"].contains("id")) {
-            view->releases.discogs_id[ri] = release["discogs"]["id"].get<int>();
-        }
+        view->releases.discogs_url[ri] = snapshot.view(release.discogs_url);
+        view->releases.discogs_id[ri] = release.discogs_id;
 
         // clear
         view->releases.artwork_filepath[ri] = "";
@@ -1515,58 +4001,56 @@ void* releases_view_loader(void* userdata)
         view->releases.select_track[ri] = 0; // reset
         memset(&view->releases.artwork_tcp[ri], 0x0, sizeof(pen::texture_creation_params));
 
-        view->releases.id[ri] = safe_str(release, "id", "");
-        view->releases.key[ri] = entry.index;
+        view->releases.id[ri] = snapshot.view(release.id);
+        view->releases.key[ri] = snapshot.view(release.key);
 
         // discogs items fetch their tracks (videos) lazily from the detail url;
         // tracks_youtube also keeps data_cache_fetch away from the track arrays
-        view->releases.resource_url[ri] = safe_str(release, "resource_url", "");
+        view->releases.resource_url[ri] = snapshot.view(release.resource_url);
         if(!view->releases.resource_url[ri].empty()) {
             view->releases.flags[ri] |= EntityFlags::details_pending | EntityFlags::tracks_youtube;
         }
 
         // assign artwork url
-        if(release["artworks"].size() > 0)
+        const SnapshotString* artworks = snapshot.refs + release.artworks_first;
+        if(release.artworks_count > 0)
         {
             size_t art_index = view->store_view.art_index;
             if(view->releases.store[ri] == "redeye")
             {
                 // this is required to fixup the fact -0.jpg may not exist
                 // redeye <guid>-1.jpg is preferable
-                size_t i = 0;
-                for(auto& art : release["artworks"])
+                for(u32 i = 0; i < release.artworks_count; ++i)
                 {
-                    std::string url = art;
-                    if(url.find("-1.jpg") != -1)
+                    if(strstr(snapshot.str(artworks[i]), "-1.jpg"))
                     {
                         art_index = i;
                         break;
                     }
-                    ++i;
                 }
             }
 
-            if(art_index < release["artworks"].size()) {
-                view->releases.artwork_url[ri] = release["artworks"][art_index];
+            if(art_index < release.artworks_count) {
+                view->releases.artwork_url[ri] = snapshot.view(artworks[art_index]);
             }
             else
             {
-                view->releases.artwork_url[ri] = "";
+                view->releases.artwork_url[ri] = {};
             }
         }
         else
         {
-            view->releases.artwork_url[ri] = "";
+            view->releases.artwork_url[ri] = {};
         }
 
         // track names
-        u32 name_count = (u32)release["track_names"].size();
+        u32 name_count = release.track_names_count;
         if(name_count > 0)
         {
             view->releases.track_names[ri] = new Str[name_count];
-            for(u32 t = 0; t < release["track_names"].size(); ++t)
+            for(u32 t = 0; t < name_count; ++t)
             {
-                view->releases.track_names[ri][t] = release["track_names"][t];
+                view->releases.track_names[ri][t] = snapshot.str(snapshot.refs[release.track_names_first + t]);
             }
 
             std::atomic_thread_fence(std::memory_order_release);
@@ -1574,13 +4058,13 @@ void* releases_view_loader(void* userdata)
         }
 
         // track urls
-        u32 url_count = (u32)release["track_urls"].size();
+        u32 url_count = release.track_urls_count;
         if(url_count > 0)
         {
             view->releases.track_urls[ri] = new Str[url_count];
-            for(u32 t = 0; t < release["track_urls"].size(); ++t)
+            for(u32 t = 0; t < url_count; ++t)
             {
-                view->releases.track_urls[ri][t] = release["track_urls"][t];
+                view->releases.track_urls[ri][t] = snapshot.str(snapshot.refs[release.track_urls_first + t]);
             }
 
             std::atomic_thread_fence(std::memory_order_release);
@@ -1588,107 +4072,268 @@ void* releases_view_loader(void* userdata)
         }
 
         // check local likes
-        if(has_like(view->releases.key[ri]))
+        if(has_like(view->releases.key[ri].c_str()))
         {
             view->releases.flags[ri] |= EntityFlags::liked;
         }
 
         // store tags
-        if(release.contains("store_tags"))
-        {
-            for(u32 t = 0; t < PEN_ARRAY_SIZE(StoreTags::names); ++t) {
-                if(release["store_tags"].contains(StoreTags::names[t]) && release["store_tags"][StoreTags::names[t]])
-                {
-                    view->releases.store_tags[ri] |= (1<<t);
-                }
+        view->releases.store_tags[ri] |= release.store_tags;
+
+        return true;
+    };
+
+    // populates the first count pending entries in batches. each batch is published with a single release
+    // store of available_entries, so the main thread and data_cache_fetch only ever see whole releases
+    auto populate_pending = [&](size_t count) {
+        size_t published = view->releases.available_entries;
+        size_t filled = 0;
+        for(size_t i = 0; i < count; ++i) {
+            if(populate(view_chart[pending[i]], (u32)(published + filled))) {
+                filled++;
+            }
+
+            if(filled == k_populate_batch_size || i + 1 == count) {
+                published += filled;
+                filled = 0;
+                view->releases.available_entries.store(published, std::memory_order_release);
             }
         }
 
-        pen::thread_sleep_ms(1);
-        view->releases.available_entries++;
+        pending.erase(pending.begin(), pending.begin() + count);
+    };
+
+    // publishes pending feed entries in chart order up to the watermark
+    auto publish = [&](f64 watermark) -> bool {
+        std::sort(begin(pending),end(pending),[&](size_t a, size_t b) {return view_chart[a].pos < view_chart[b].pos; });
+
+        size_t count = 0;
+        while(count < pending.size() && view_chart[pending[count]].pos <= watermark) {
+            ++count;
+        }
+
+        // make space
+        if(!grow_view_releases(view, count)) {
+            return false;
+        }
+
+        populate_pending(count);
+        return true;
+    };
+
+    if(view->page == Page::feed) {
+        if(!publish(publish_watermark())) {
+            view->threads_terminated++;
+            return nullptr;
+        }
+    }
+    else {
+        // likes and search results build an in memory snapshot so they populate the same way as the feed
+        snapshots.emplace_back();
+        RegistrySnapshot& snapshot = snapshots.back();
+        build_registry_snapshot(releases_registry, nullptr, snapshot.buffer);
+        fixup_registry_snapshot(snapshot, snapshot.buffer.data(), snapshot.buffer.size());
+
+        FlatHashMap<u32> records;
+        records.reserve(snapshot.header->record_count);
+        for(u32 r = 0; r < snapshot.header->record_count; ++r) {
+            const SnapshotString& key = snapshot.records[r].key;
+            records.insert(hash64(snapshot.str(key), key.length), r);
+        }
+
+        for(auto& entry : view_chart) {
+            u32* record = records.find(hash64(entry.index.c_str(), entry.index.length()));
+            if(record) {
+                entry.snapshot = &snapshot;
+                entry.record = *record;
+            }
+        }
+
+        // sort the items
+        if(view->page == Page::likes) {
+            // likes are sorted descending by timestamp
+            std::sort(begin(view_chart),end(view_chart),[](ChartItem a, ChartItem b) {return a.pos > b.pos; });
+        }
+        else {
+            // search results are sorted ascending by position
+            std::sort(begin(view_chart),end(view_chart),[](ChartItem a, ChartItem b) {return a.pos < b.pos; });
+        }
+
+        // make space
+        grow_view_releases(view, view_chart.size());
+
+        for(size_t i = 0; i < view_chart.size(); ++i) {
+            pending.push_back(i);
+        }
+        populate_pending(pending.size());
+    }
+
+    view->populated_ms = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+    PEN_LOG("populated %zu releases in %.1fms", view->releases.available_entries.load(), view->populated_ms.load());
+
+    // stale while revalidate: refresh sections populated from the cache and flag the view if
+    // anything changed, the main thread then swaps in a view built from the fresh cache
+    bool changed = false;
+    for(auto& stale : stale_sections) {
+        if(view->terminate) {
+            break;
+        }
+
+        std::vector<u8> data;
+        if(revalidate_registry_snapshot(stale.url.c_str(), stale.cache_file.c_str(), stale.index_on.c_str(), data)) {
+            write_registry_snapshot(stale.snapshot_filepath, data);
+            changed = true;
+        }
+    }
+
+    // delta sync the local copies, a patched copy of one this view is paging through is the same as a revalidate
+    for(auto& section : sections) {
+        if(view->terminate) {
+            break;
+        }
+
+        bool patched = false;
+        if(section.needs_sync && sync_registry_index(section.index_on, patched) && patched && section.synced) {
+            changed = true;
+        }
     }
 
-    // discogs: serialised detail fetch queue turning release videos into tracks,
-    // spaced out to respect the discogs rate limit (~60 requests per minute)
+    if(changed && !view->terminate) {
+        view->revalidated = 1;
+    }
+
+    // discogs: detail fetch queue turning release videos into tracks. a few workers pull from the queue
+    // in order and overlap their requests, the shared rate limiter in discogs_request paces them
     if(view->page == Page::discogs) {
         Str token = discogs_get_token();
-        for(size_t i = 0; i < view->releases.available_entries; ++i) {
-            if(view->terminate) {
-                break;
-            }
+        std::atomic<size_t> next = { 0 };
 
-            if(!(view->releases.flags[i] & EntityFlags::details_pending)) {
-                continue;
-            }
+        auto detail_worker = [&]() {
+            for(;;) {
+                size_t i = next++;
+                if(view->terminate || i >= view->releases.available_entries) {
+                    break;
+                }
 
-            long http_code = 0;
-            auto detail = curl::discogs_request(
-                "GET", view->releases.resource_url[i].c_str(), token.c_str(), nullptr, &http_code);
+                if(!(view->releases.flags[i] & EntityFlags::details_pending)) {
+                    continue;
+                }
 
-            if(http_code == 429) {
-                // rate limited: cool off then retry this item
-                for(u32 s = 0; s < 80 && !view->terminate; ++s) {
-                    pen::thread_sleep_ms(100);
+                // rate limited: the limiter holds the retry until there is budget again
+                long http_code = 429;
+                nlohmann::json detail;
+                while(http_code == 429 && !view->terminate) {
+                    detail = curl::discogs_request(
+                        "GET", view->releases.resource_url[i].c_str(), token.c_str(), nullptr, &http_code, &view->terminate);
                 }
-                --i;
-                continue;
-            }
 
-            // videos become playable tracks via the hidden youtube player.
-            // the video list is noisy: the same video can appear more than once
-            // and some uris are not youtube at all, so dedupe on video id and
-            // keep only playable entries. track names are the video titles
-            std::vector<Str> video_names;
-            std::vector<Str> video_urls;
-            std::set<std::string> seen_video_ids;
+                if(view->terminate) {
+                    break;
+                }
 
-            if(detail.contains("videos") && detail["videos"].is_array()) {
-                for(auto& video : detail["videos"]) {
-                    Str uri = safe_str(video, "uri", "");
+                // videos become playable tracks via the hidden youtube player.
+                // the video list is noisy: the same video can appear more than once
+                // and some uris are not youtube at all, so dedupe on video id and
+                // keep only playable entries. track names are the video titles
+                std::vector<Str> video_names;
+                std::vector<Str> video_urls;
+                std::set<std::string> seen_video_ids;
+
+                if(detail.contains("videos") && detail["videos"].is_array()) {
+                    for(auto& video : detail["videos"]) {
+                        Str uri = safe_str(video, "uri", "");
+
+                        Str vid = yt_video_id_from_url(uri);
+                        if(vid.empty()) {
+                            continue;
+                        }
 
-                    Str vid = yt_video_id_from_url(uri);
-                    if(vid.empty()) {
-                        continue;
+                        if(!seen_video_ids.insert(vid.c_str()).second) {
+                            continue;
+                        }
+
+                        video_names.push_back(safe_str(video, "title", ""));
+                        video_urls.push_back(uri);
                     }
+                }
 
-                    if(!seen_video_ids.insert(vid.c_str()).second) {
-                        continue;
+                u32 count = (u32)video_names.size();
+                if(count > 0) {
+                    Str* names = new Str[count];
+                    Str* urls = new Str[count];
+                    Str* filepaths = new Str[count];
+
+                    for(u32 t = 0; t < count; ++t) {
+                        names[t] = video_names[t];
+                        urls[t] = video_urls[t];
+                        filepaths[t] = video_urls[t];
                     }
 
-                    video_names.push_back(safe_str(video, "title", ""));
-                    video_urls.push_back(uri);
+                    view->releases.track_names[i] = names;
+                    view->releases.track_urls[i] = urls;
+                    view->releases.track_filepaths[i] = filepaths;
+
+                    std::atomic_thread_fence(std::memory_order_release);
+                    view->releases.track_name_count[i] = count;
+                    view->releases.track_url_count[i] = count;
+                    view->releases.track_filepath_count[i] = count;
                 }
+
+                std::atomic_thread_fence(std::memory_order_release);
+                view->releases.flags[i] |= EntityFlags::tracks_cached;
+                view->releases.flags[i] &= ~((u64)EntityFlags::details_pending);
             }
+        };
+
+        std::vector<std::thread> workers;
+        for(u32 w = 0; w < k_discogs_detail_workers; ++w) {
+            workers.push_back(std::thread(detail_worker));
+        }
 
-            u32 count = (u32)video_names.size();
-            if(count > 0) {
-                Str* names = new Str[count];
-                Str* urls = new Str[count];
-                Str* filepaths = new Str[count];
+        for(auto& worker : workers) {
+            worker.join();
+        }
+    }
 
-                for(u32 t = 0; t < count; ++t) {
-                    names[t] = video_names[t];
-                    urls[t] = video_urls[t];
-                    filepaths[t] = video_urls[t];
+    // feed: fetch the next page once the user scrolls near the end of what is published. the section
+    // holding back the watermark goes first, when every section is exhausted the whole feed is published
+    if(view->page == Page::feed) {
+        while(!view->terminate) {
+            FeedSection* next = nullptr;
+            for(auto& section : sections) {
+                if(!section.exhausted && (!next || section.last_pos < next->last_pos)) {
+                    next = &section;
                 }
+            }
 
-                view->releases.track_names[i] = names;
-                view->releases.track_urls[i] = urls;
-                view->releases.track_filepaths[i] = filepaths;
+            if(!next) {
+                break;
+            }
 
-                std::atomic_thread_fence(std::memory_order_release);
-                view->releases.track_name_count[i] = count;
-                view->releases.track_url_count[i] = count;
-                view->releases.track_filepath_count[i] = count;
+            // sleep until the user scrolls near the end, issue_data_requests notifies as top_pos moves. only
+            // this thread publishes entries so available_entries can't change under the wait
+            {
+                std::unique_lock<std::mutex> lock(view->grow_mutex);
+                view->grow_cv.wait(lock, [view]() {
+                    return view->top_pos + k_feed_page_ahead >= (s32)view->releases.available_entries || view->terminate;
+                });
             }
 
-            std::atomic_thread_fence(std::memory_order_release);
-            view->releases.flags[i] |= EntityFlags::tracks_cached;
-            view->releases.flags[i] &= ~((u64)EntityFlags::details_pending);
+            if(view->terminate) {
+                break;
+            }
+
+            if(!fetch_page(*next)) {
+                // offline or failed, try again shortly while the user is still at the end
+                std::unique_lock<std::mutex> lock(view->grow_mutex);
+                view->grow_cv.wait_for(lock, std::chrono::seconds(1), [view]() {
+                    return (bool)view->terminate;
+                });
+                continue;
+            }
 
-            // spacing between requests
-            for(u32 s = 0; s < 12 && !view->terminate; ++s) {
-                pen::thread_sleep_ms(100);
+            if(!publish(publish_watermark())) {
+                break;
             }
         }
     }
@@ -1735,11 +4380,122 @@ void* data_cache_fetch(void* userdata) {
     // get view from userdata
     ReleasesView* view = (ReleasesView*)userdata;
 
-    Str cache_dir = get_cache_path();
+    // downloads are submitted to the curl engine and complete in parallel. completions are queued
+    // on the view and applied here, so the soa is only written from this thread as before
+    struct TrackFetch {
+        std::vector<u64> ids;
+        u32              remaining = 0;
+        bool             cancelled = false;
+    };
+    std::map<size_t, u64> artwork_in_flight;
+    std::map<size_t, TrackFetch> tracks_in_flight;
+
+    auto on_complete = [view](u32 index, s32 track) {
+        return [view, index, track](const Str& filepath, bool cancelled) {
+            view->fetch_mutex.lock();
+            view->fetch_results.push_back({index, track, filepath, cancelled});
+            view->fetch_mutex.unlock();
+            view->fetches_in_flight--;
+        };
+    };
+
+    // lower is sooner. foreground views come before background ones, then assets are ordered by
+    // distance from the top release with the artwork ahead of the selected track, ahead of the
+    // remaining tracks at the same distance
+    auto asset_priority = [view](size_t i, u32 asset) {
+        u64 background = view->foreground ? 0 : 1;
+        u64 dist = (u64)abs((s32)i - view->top_pos);
+        return (background << 32) | (dist * AssetType::count + asset);
+    };
+
+    auto track_priority = [&](size_t i, u32 t) {
+        return asset_priority(i, t == view->releases.select_track[i] ? AssetType::selected_track : AssetType::track);
+    };
 
     for(;;) {
+        // hold off while the loader grows the soa
+        park_for_view_growth(view);
+
+        // apply completed downloads
+        std::vector<CacheFetchResult> results;
+        view->fetch_mutex.lock();
+        results.swap(view->fetch_results);
+        view->fetch_mutex.unlock();
+
+        for(auto& result : results) {
+            size_t i = result.index;
+            if(result.track == -1) {
+                // cancelled artwork is requested again when the release comes back into range
+                if(!result.cancelled) {
+                    view->releases.artwork_filepath[i] = result.filepath;
+                    std::atomic_thread_fence(std::memory_order_release);
+                    view->releases.flags[i] |= EntityFlags::artwork_cached;
+                }
+                artwork_in_flight.erase(i);
+            }
+            else {
+                auto& fetch = tracks_in_flight[i];
+                if(result.cancelled)
+                {
+                    fetch.cancelled = true;
+                }
+                else if(check_audio_file(result.filepath))
+                {
+                    view->releases.track_filepaths[i][result.track] = result.filepath;
+                }
+                else
+                {
+                    remove(result.filepath.c_str());
+                }
+
+                // all tracks for the release are done
+                if(--fetch.remaining == 0) {
+                    if(fetch.cancelled) {
+                        // start over when the release comes back into range
+                        delete[] view->releases.track_filepaths[i];
+                        view->releases.track_filepaths[i] = nullptr;
+                    }
+                    else {
+                        std::atomic_thread_fence(std::memory_order_release);
+                        view->releases.flags[i] |= EntityFlags::tracks_cached;
+                        view->releases.track_filepath_count[i] = view->releases.track_url_count[i];
+                    }
+                    tracks_in_flight.erase(i);
+                }
+            }
+        }
+
+        // cancel anything for releases which have left the cache window, or everything on terminate
+        for(auto& artwork : artwork_in_flight) {
+            if(view->terminate || !(view->releases.flags[artwork.first] & EntityFlags::cache_url_requested)) {
+                curl::cancel(artwork.second);
+            }
+            else {
+                curl::set_priority(artwork.second, asset_priority(artwork.first, AssetType::artwork));
+            }
+        }
+
+        for(auto& tracks : tracks_in_flight) {
+            size_t i = tracks.first;
+            bool cancel = view->terminate || !(view->releases.flags[i] & EntityFlags::cache_url_requested);
+            for(u32 t = 0; t < tracks.second.ids.size(); ++t) {
+                if(cancel) {
+                    curl::cancel(tracks.second.ids[t]);
+                }
+                else {
+                    curl::set_priority(tracks.second.ids[t], track_priority(i, t));
+                }
+            }
+        }
+
         if(view->terminate) {
-            break;
+            // completion callbacks reference the view, wait for anything still in flight
+            if(view->fetches_in_flight == 0) {
+                break;
+            }
+
+            pen::thread_sleep_ms(16);
+            continue;
         }
 
         // waits on info loader thread
@@ -1750,9 +4506,11 @@ void* data_cache_fetch(void* userdata) {
 
             // cache art
             if(!view->releases.artwork_url[i].empty()) {
-                if(view->releases.artwork_filepath[i].empty()) {
-                    view->releases.artwork_filepath[i] = download_and_cache(view->releases.artwork_url[i], view->releases.key[i], true);
-                    view->releases.flags[i] |= EntityFlags::artwork_cached;
+                if(view->releases.artwork_filepath[i].empty() && artwork_in_flight.find(i) == artwork_in_flight.end()) {
+                    view->fetches_in_flight++;
+                    artwork_in_flight[i] = download_and_cache_async(
+                        view->releases.artwork_url[i].to_str(), view->releases.key[i].to_str(), true, TransferCategory::artwork,
+                        asset_priority(i, AssetType::artwork), on_complete((u32)i, -1));
                 }
             }
 
@@ -1762,46 +4520,38 @@ void* data_cache_fetch(void* userdata) {
                 // releases_view_loader; nothing to download here
             }
             else if(!(view->releases.flags[i] & EntityFlags::tracks_cached)) {
-                if(view->releases.track_url_count[i] > 0 && view->releases.track_filepaths[i] == nullptr) {
-                    view->releases.track_filepaths[i] = new Str[view->releases.track_url_count[i]];
-                    for(u32 t = 0; t < view->releases.track_url_count[i]; ++t) {
-                        view->releases.track_filepaths[i][t] = "";
-                        if(!k_force_streamed_audio)
-                        {
-                            Str fp = download_and_cache(view->releases.track_urls[i][t], view->releases.key[i], true);
-
-                            if(check_audio_file(fp))
-                            {
-                                view->releases.track_filepaths[i][t] = fp;
-                            }
-                            else
-                            {
-                                remove(fp.c_str());
-                            }
+                u32 url_count = view->releases.track_url_count[i];
+                if(url_count > 0 && view->releases.track_filepaths[i] == nullptr) {
+                    view->releases.track_filepaths[i] = new Str[url_count];
+                    if(!k_force_streamed_audio)
+                    {
+                        auto& fetch = tracks_in_flight[i];
+                        fetch.remaining = url_count;
+                        for(u32 t = 0; t < url_count; ++t) {
+                            view->releases.track_filepaths[i][t] = "";
+                            view->fetches_in_flight++;
+                            fetch.ids.push_back(download_and_cache_async(
+                                view->releases.track_urls[i][t], view->releases.key[i].to_str(), true, TransferCategory::audio,
+                                track_priority(i, t), on_complete((u32)i, (s32)t)));
                         }
-                        else
-                        {
-                            //
+                    }
+                    else
+                    {
+                        for(u32 t = 0; t < url_count; ++t) {
                             view->releases.track_filepaths[i][t] = view->releases.track_urls[i][t];
                         }
+                        std::atomic_thread_fence(std::memory_order_release);
+                        view->releases.flags[i] |= EntityFlags::tracks_cached;
+                        view->releases.track_filepath_count[i] = url_count;
                     }
-                    std::atomic_thread_fence(std::memory_order_release);
-                    view->releases.flags[i] |= EntityFlags::tracks_cached;
-                    view->releases.track_filepath_count[i] = view->releases.track_url_count[i];
                 }
-                else
+                else if(url_count == 0)
                 {
                     std::atomic_thread_fence(std::memory_order_release);
                     view->releases.flags[i] |= EntityFlags::tracks_cached;
                     view->releases.track_filepath_count[i] = 0;
                 }
             }
-
-
-            // early out
-            if(view->terminate) {
-                break;
-            }
         }
 
         pen::thread_sleep_ms(16);
@@ -1822,18 +4572,31 @@ void* data_loader(void* userdata)
             break;
         }
 
-        for(size_t i = 0; i < view->releases.available_entries; ++i) {
-            // load art if cached and not loaded
-            std::atomic_thread_fence(std::memory_order_acquire);
-            if((view->releases.flags[i] & EntityFlags::artwork_cached) &&
-               !(view->releases.flags[i] & EntityFlags::artwork_loaded) &&
-               (view->releases.flags[i] & EntityFlags::artwork_requested)) {
-                view->releases.artwork_tcp[i] = load_texture_from_disk(view->releases.artwork_filepath[i]);
-
-                if(view->releases.artwork_tcp[i].data)
-                {
-                    std::atomic_thread_fence(std::memory_order_release);
-                    view->releases.flags[i] |= EntityFlags::artwork_loaded;
+        // hold off while the loader grows the soa
+        park_for_view_growth(view);
+
+        // visit releases outward from the top release so the visible artwork decodes first
+        s32 count = (s32)view->releases.available_entries;
+        s32 top = std::min<s32>(std::max<s32>(view->top_pos, 0), count);
+        for(s32 d = 0; top - d >= 0 || top + d < count; ++d) {
+            for(s32 side = 0; side < 2; ++side) {
+                s32 i = side == 0 ? top + d : top - d;
+                if(i < 0 || i >= count || (side == 1 && d == 0)) {
+                    continue;
+                }
+
+                // load art if cached and not loaded
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if((view->releases.flags[i] & EntityFlags::artwork_cached) &&
+                   !(view->releases.flags[i] & EntityFlags::artwork_loaded) &&
+                   (view->releases.flags[i] & EntityFlags::artwork_requested)) {
+                    view->releases.artwork_tcp[i] = load_texture_from_disk(view->releases.artwork_filepath[i]);
+
+                    if(view->releases.artwork_tcp[i].data)
+                    {
+                        std::atomic_thread_fence(std::memory_order_release);
+                        view->releases.flags[i] |= EntityFlags::artwork_loaded;
+                    }
                 }
             }
         }
@@ -1925,12 +4688,13 @@ namespace
         ctx.data_ctx.user_data.status = Status::e_invalidated;
     }
 
-    ReleasesView* new_view(Page_t page, StoreView store_view) {
+    ReleasesView* new_view(Page_t page, StoreView store_view, CachePolicy_t cache_policy = CachePolicy::stale_while_revalidate) {
         ReleasesView* view = new ReleasesView;
         view->data_ctx = &ctx.data_ctx;
         view->page = page;
         view->scroll = vec2f(0.0f, ctx.w);
         view->store_view = store_view;
+        view->cache_policy = cache_policy;
 
         // workers per view
         view->thread_mem[0] = pen::thread_create(releases_view_loader, 10 * 1024 * 1024, view, pen::e_thread_start_flags::detached);
@@ -1970,7 +4734,8 @@ namespace
         return view;
     }
 
-    ReleasesView* reload_view() {
+    // pull to reload goes to the network, a revalidated view rebuilds from the freshly written cache
+    ReleasesView* reload_view(CachePolicy_t cache_policy = CachePolicy::network_first) {
         if(ctx.view)
         {
             // discogs views search live and carry no store view
@@ -1979,7 +4744,7 @@ namespace
             }
 
             auto store_view = store_view_from_store(ctx.view->page, ctx.store);
-            return new_view(ctx.view->page, store_view);
+            return new_view(ctx.view->page, store_view, cache_policy);
         }
 
         return nullptr;
@@ -2209,6 +4974,25 @@ namespace
         return output;
     }
 
+    // grows the soa of views whose loader is paging in more releases, once the readers have parked
+    void grow_views()
+    {
+        std::set<ReleasesView*> views = ctx.background_views;
+        views.insert(ctx.view);
+        views.insert(ctx.reload_view);
+
+        for(auto& view : views)
+        {
+            if(view && view->grow_size && !view->terminate && view->readers_parked == k_num_soa_readers)
+            {
+                std::lock_guard<std::mutex> lock(view->grow_mutex);
+                resize_components(view->releases, view->grow_size);
+                view->grow_size = 0;
+                view->grow_cv.notify_all();
+            }
+        }
+    }
+
     void cleanup_views()
     {
         std::vector<ReleasesView*> to_remove;
@@ -2217,7 +5001,12 @@ namespace
         {
             if(view != ctx.back_view && view != ctx.view)
             {
-                view->terminate = 1;
+                // wake the loader and readers if they are waiting on a grow
+                if(!view->terminate) {
+                    std::lock_guard<std::mutex> lock(view->grow_mutex);
+                    view->terminate = 1;
+                    view->grow_cv.notify_all();
+                }
                 if(view->threads_terminated == k_num_threads_per_view)
                 {
                     auto& releases = view->releases;
@@ -2262,22 +5051,16 @@ namespace
                             delete[] view->releases.track_urls[i];
                         }
 
-                        // unload strings
-                        releases.id[i].clear();
-                        releases.artist[i].clear();
-                        releases.title[i].clear();
-                        releases.link[i].clear();
-                        releases.label[i].clear();
-                        releases.cat[i].clear();
-                        releases.store[i].clear();
-                        releases.artwork_url[i].clear();
-                        releases.label_link[i].clear();
-                        releases.resource_url[i].clear();
+                        // unload strings, the text columns are released with the snapshots below
+                        releases.artwork_filepath[i].clear();
                     }
 
                     // cleanup memory from the soa itself
                     free_components(view->releases);
 
+                    // text columns are views into the snapshots, released in one go
+                    view->snapshots.clear();
+
                     // freeup the thread mem
                     for(u32 t = 0; t < k_num_threads_per_view; ++t) {
                         free(view->thread_mem[t]);
@@ -2356,6 +5139,18 @@ namespace
             ImGui::SetWindowFontScale(1.0f);
         }
 
+        // fresher data arrived for a view populated from the cache. merge it in by swapping in a
+        // view built from the updated cache, but only while the user is still at the top of the feed
+        // so the feed doesn't jump under them. otherwise the fresh data is used by the next view
+        if(ctx.view->revalidated && ctx.reload_view == nullptr)
+        {
+            ctx.view->revalidated = 0;
+            if(ctx.view->page == Page::feed && ctx.top <= 0)
+            {
+                ctx.reload_view = reload_view(CachePolicy::cache_only);
+            }
+        }
+
         // if reloading wait until the new view has entries and then swap
         if(ctx.reload_view)
         {
@@ -2537,6 +5332,9 @@ namespace
             ImGui::SetWindowFontScale(k_text_size_body);
         }
 
+        // make room for paged in releases
+        grow_views();
+
         // cleanup memory on old views
         cleanup_views();
     }
@@ -2827,7 +5625,7 @@ namespace
             ImGui::SetWindowFontScale(k_text_size_h2);
             f32 menu_w = ImGui::CalcTextSize("Open In Discogs").x + (pad * 2.0);
 
-            Str discogs_link = releases.discogs_url[r];
+            Str discogs_link = releases.discogs_url[r].to_str();
             more_menu_pos.x = ctx.w - menu_w;
             ImGui::SetNextWindowPos(more_menu_pos);
             ImGui::SetNextWindowSize(ImVec2(menu_w, 0.0f));
@@ -3352,7 +6150,7 @@ namespace
                 if(!scrolling && lenient_button_tap(0.1))
                 {
                     pen::os_haptic_selection_feedback();
-                    remove_like(releases.key[r]);
+                    remove_like(releases.key[r].to_str());
                     releases.like_count[r] = std::max<u32>(releases.like_count[r]--, 0);
                     releases.flags[r] &= ~EntityFlags::liked;
                 }
@@ -3364,7 +6162,7 @@ namespace
                 if(!scrolling && lenient_button_tap(0.1))
                 {
                     pen::os_haptic_selection_feedback();
-                    add_like(releases.key[r]);
+                    add_like(releases.key[r].to_str());
                     releases.like_count[r]++;
                     releases.flags[r] |= EntityFlags::liked;
                 }
@@ -3395,7 +6193,7 @@ namespace
         }
 
         if(!scrolling && lenient_button_tap(0.1)) {
-            ctx.open_url_request = releases.link[r];
+            ctx.open_url_request = releases.link[r].to_str();
         }
         ImGui::PopID();
 
@@ -3572,6 +6370,22 @@ namespace
     {
         auto& releases = ctx.view->releases;
 
+        // publish the on screen view and position to the fetch scheduler
+        for(auto& view : ctx.background_views) {
+            view->foreground = 0;
+        }
+        ctx.view->foreground = 1;
+        if(ctx.reload_view) {
+            ctx.reload_view->foreground = 1;
+        }
+
+        // the feed loader waits on grow_cv for the user to scroll towards the end
+        if(ctx.top != -1 && ctx.view->top_pos != ctx.top) {
+            std::lock_guard<std::mutex> lock(ctx.view->grow_mutex);
+            ctx.view->top_pos = ctx.top;
+            ctx.view->grow_cv.notify_all();
+        }
+
         // make requests for data
         if(ctx.top != -1) {
             s32 range_start = max<s32>(ctx.top - k_ram_cache_range, 0);
@@ -3776,6 +6590,7 @@ namespace
                 ctx.view->releases.soa_size.load(),
                 ctx.top
             );
+            ImGui::Text("populated: %.1f (ms)", ctx.view->populated_ms.load());
         }
 
         ImGui::Text("cache: %i (%imb)",
@@ -3783,6 +6598,50 @@ namespace
             (u32)(ctx.data_ctx.cached_release_bytes.load() / 1024 / 1024)
         );
 
+        // compressed json transfers
+        u64 wire_bytes = curl::s_stats.wire_bytes.load();
+        u64 decoded_bytes = curl::s_stats.decoded_bytes.load();
+        ImGui::Text("json: %i requests %ikb -> %ikb (%.1fx)",
+            (u32)curl::s_stats.requests.load(),
+            (u32)(wire_bytes / 1024),
+            (u32)(decoded_bytes / 1024),
+            wire_bytes > 0 ? (f64)decoded_bytes / (f64)wire_bytes : 1.0
+        );
+
+        // network telemetry, p50 / p95 / p99 per category
+        std::vector<curl::TransferRecord> records;
+        for(u32 c = 0; c < TransferCategory::count; ++c)
+        {
+            curl::telemetry_snapshot(c, records);
+            if(records.empty()) {
+                continue;
+            }
+
+            f32 total[3], ttfb[3], dns[3], connect[3], tls[3];
+            curl::telemetry_percentiles(records, &curl::TransferRecord::total_ms, total);
+            curl::telemetry_percentiles(records, &curl::TransferRecord::ttfb_ms, ttfb);
+            curl::telemetry_percentiles(records, &curl::TransferRecord::dns_ms, dns);
+            curl::telemetry_percentiles(records, &curl::TransferRecord::connect_ms, connect);
+            curl::telemetry_percentiles(records, &curl::TransferRecord::tls_ms, tls);
+
+            u32 errors = 0;
+            for(auto& r : records) {
+                errors += (r.http_code < 200 || r.http_code >= 400) ? 1 : 0;
+            }
+
+            ImGui::Text("%s: %i (%i errors)", curl::k_transfer_category_names[c], (u32)records.size(), errors);
+            ImGui::Text("  total %.0f / %.0f / %.0f (ms)", total[0], total[1], total[2]);
+            ImGui::Text("  ttfb %.0f / %.0f / %.0f (ms)", ttfb[0], ttfb[1], ttfb[2]);
+            ImGui::Text("  dns %.0f conn %.0f tls %.0f (p50 ms)", dns[0], connect[0], tls[0]);
+        }
+
+        if(ImGui::Button("Dump Telemetry")) {
+            Str filepath = get_persistent_filepath("telemetry.json", true);
+            if(curl::dump_telemetry(filepath.c_str())) {
+                PEN_LOG("telemetry written to: %s", filepath.c_str());
+            }
+        }
+
         //
         ImGui::Text("scroll: %f", ctx.scroll_pos_y);
 
@@ -3928,7 +6787,7 @@ namespace
 
                 CURLcode code;
                 auto response = curl::request(
-                    curl::url_with_key("https://identitytoolkit.googleapis.com/v1/accounts:sendOobCode").c_str(),
+                    curl::url_with_key(curl::identity_url("/v1/accounts:sendOobCode").c_str()).c_str(),
                     jstr.c_str(),
                     code
                 );
@@ -4074,7 +6933,7 @@ namespace
 
                 CURLcode code;
                 auto response = curl::request(
-                    curl::url_with_key("https://identitytoolkit.googleapis.com/v1/accounts:signInWithPassword").c_str(),
+                    curl::url_with_key(curl::identity_url("/v1/accounts:signInWithPassword").c_str()).c_str(),
                     jstr.c_str(),
                     code
                 );
@@ -4220,7 +7079,7 @@ namespace
 
                     CURLcode code;
                     response = curl::request(
-                        curl::url_with_key("https://identitytoolkit.googleapis.com/v1/accounts:signUp").c_str(),
+                        curl::url_with_key(curl::identity_url("/v1/accounts:signUp").c_str()).c_str(),
                         jstr.c_str(),
                         code
                     );
@@ -4347,7 +7206,7 @@ namespace
 
             CURLcode code;
             auto response = curl::request(
-                curl::url_with_key("https://identitytoolkit.googleapis.com/v1/accounts:signInWithPassword").c_str(),
+                curl::url_with_key(curl::identity_url("/v1/accounts:signInWithPassword").c_str()).c_str(),
                 jstr.c_str(),
                 code
             );
@@ -4601,11 +7460,13 @@ namespace
         fonts.push_back({"data/fonts/cousine-regular.ttf", font_pixel_size, 0x2013, 0x2019, true});
         fonts.push_back({"data/fonts/fontawesome-webfont.ttf", font_pixel_size, ICON_MIN_FA, ICON_MAX_FA, true});
 
+        // start connecting while the ui initialises
+        curl::init();
+        pen::thread_create(connection_warm_up, 1024 * 1024, nullptr, pen::e_thread_start_flags::detached);
+
         // init dev ui with font
         dev_ui::init_ex(fonts);
 
-        curl::init();
-
         // init context
         ctx.status_bar_height = pen::os_get_status_bar_portrait_height();
 
@@ -4734,7 +7595,8 @@ bool discogs_has_filters()
 
 Str discogs_build_search_url()
 {
-    Str url = "https://api.discogs.com/database/search?per_page=50&page=1";
+    Str url = curl::discogs_api_url();
+    url.append("/database/search?per_page=50&page=1");
 
     CURL* curl = curl_easy_init();
     auto append_param = [&](const c8* name, const std::string& value) {
@@ -4803,12 +7665,12 @@ void audio_player_toggle_like() {
     auto& releases = ctx.view->releases;
 
     if(releases.flags[r] & EntityFlags::liked) {
-        remove_like(releases.key[r]);
+        remove_like(releases.key[r].to_str());
         releases.like_count[r] = std::max<u32>(releases.like_count[r]--, 0);
         releases.flags[r] &= ~EntityFlags::liked;
     }
     else {
-        add_like(releases.key[r]);
+        add_like(releases.key[r].to_str());
         releases.like_count[r]++;
         releases.flags[r] |= EntityFlags::liked;
     }
@@ -4998,7 +7860,7 @@ void yt_player()
             if(t < releases.track_name_count[r]) {
                 track_name = releases.track_names[r][t];
             }
-            pen::music_set_now_playing(releases.artist[r], releases.title[r], track_name);
+            pen::music_set_now_playing(releases.artist[r].to_str(), releases.title[r].to_str(), track_name);
 
             audio_ctx.yt_active = true;
             audio_ctx.invalidate_track = false;
@@ -5131,7 +7993,7 @@ void audio_player()
                     track_name = releases.track_names[r][t];
                 }
 
-                pen::music_set_now_playing(releases.artist[r], releases.title[r], track_name);
+                pen::music_set_now_playing(releases.artist[r].to_str(), releases.title[r].to_str(), track_name);
 
                 audio_ctx.invalidate_track = false;
                 audio_ctx.started = false;
@@ -5174,7 +8036,7 @@ void audio_player()
                             track_name = releases.track_names[r][t];
                         }
 
-                        pen::music_set_now_playing(releases.artist[r], releases.title[r], track_name);
+                        pen::music_set_now_playing(releases.artist[r].to_str(), releases.title[r].to_str(), track_name);
 
                         audio_ctx.now_playing_artwork_filepath = ""; // music_set_now_playing rebuilds the info dict, so re-send artwork
                         audio_ctx.invalidate_track = false;
@@ -5254,16 +8116,16 @@ void audio_player()
     }
 }
 
-bool has_like(const Str& id) {
+bool has_like(const c8* id) {
     bool ret = false;
     ctx.data_ctx.user_data.mutex.lock();
     if(ctx.data_ctx.user_data.dict.contains("likes")) {
-        if(ctx.data_ctx.user_data.dict["likes"].contains(id.c_str())) {
-            if(ctx.data_ctx.user_data.dict["likes"][id.c_str()].is_boolean()) {
-                ret = ctx.data_ctx.user_data.dict["likes"][id.c_str()];
+        if(ctx.data_ctx.user_data.dict["likes"].contains(id)) {
+            if(ctx.data_ctx.user_data.dict["likes"][id].is_boolean()) {
+                ret = ctx.data_ctx.user_data.dict["likes"][id];
             }
-            else if(ctx.data_ctx.user_data.dict["likes"][id.c_str()].is_number()) {
-                ret = ctx.data_ctx.user_data.dict["likes"][id.c_str()] > 0;
+            else if(ctx.data_ctx.user_data.dict["likes"][id].is_number()) {
+                ret = ctx.data_ctx.user_data.dict["likes"][id] > 0;
             }
         }
     }
@@ -5292,7 +8154,7 @@ void increment_server_like(const Str& id, s32 amount)
 {
     // increment like
     Str patch_url;
-    patch_url.setf("https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/releases/%s/likes/count.json", id.c_str());
+    patch_url.setf("%s/releases/%s/likes/count.json", curl::firebase_base_url(), id.c_str());
     patch_url = append_auth(patch_url);
     CURLcode res;
 
@@ -5314,11 +8176,16 @@ void increment_server_like(const Str& id, s32 amount)
         }
     }
 
-    // str payload
+    // the count goes with a server time like stamp, delta syncing clients fetch releases by it to pick up
+    // like counts the scrape stamp doesn't cover
+    Str likes_url;
+    likes_url.setf("%s/releases/%s/likes.json", curl::firebase_base_url(), id.c_str());
+    likes_url = append_auth(likes_url);
+
     Str payload;
-    payload.setf("%i", val);
+    payload.setf("{\"count\": %i, \"updated\": {\".sv\": \"timestamp\"}}", val);
 
-    auto response = curl::request(patch_url.c_str(), payload.c_str(), res, "PUT");
+    auto response = curl::request(likes_url.c_str(), payload.c_str(), res, "PATCH");
 }
 
 void add_like(const Str& id)
@@ -5328,44 +8195,30 @@ void add_like(const Str& id)
     ctx.data_ctx.user_data.mutex.unlock();
     ctx.data_ctx.user_data.status = Status::e_invalidated;
 
-    // async find the release and cache it to the likes cache
+    // async find the release and journal it to the likes cache
     std::thread cache_thread([id]() {
-        // open cache
-        Str filepath = get_persistent_filepath("likes_feed.json", true);
-        auto likes_registry = nlohmann::json();
-        try {
-            likes_registry = nlohmann::json::parse(std::ifstream(filepath.c_str()));
-
-        } catch (...) {
-            // ..
-        }
-
         // grab the release info
         Str search_url;
-        search_url.setf("https://diig-19d4c-default-rtdb.europe-west1.firebasedatabase.app/releases/%s.json", id.c_str());
+        search_url.setf("%s/releases/%s.json", curl::firebase_base_url(), id.c_str());
         search_url = append_auth(search_url);
 
         auto db = curl::download(search_url.c_str());
         if(db.data)
         {
-            // store in reg
-            nlohmann::json release;
+            // the path query returns the release itself
             try {
-                release = nlohmann::json::parse(db.data);
+                auto release = nlohmann::json::parse(db.data, db.data + db.size);
                 increment_server_like(id, 1);
-                likes_registry[id.c_str()] = release[id.c_str()];
+                if(release.is_object()) {
+                    PEN_LOG("add %s to likes registry", id.c_str());
+                    likes_journal_add(id.c_str(), std::move(release));
+                }
             }
             catch(...) {
                 // ..
             }
         }
-
-        // write to disk
-        PEN_LOG("add %s to likes registry", id.c_str());
-        FILE* fp = fopen(filepath.c_str(), "wb");
-        std::string j = likes_registry.dump();
-        fwrite(j.c_str(), j.length(), 1, fp);
-        fclose(fp);
+        curl::release_buffer(db);
     });
     cache_thread.detach();
 }
@@ -5381,28 +8234,13 @@ void remove_like(const Str& id)
     ctx.data_ctx.user_data.status = Status::e_invalidated;
 
     // remove the entry from the likes registry
-    std::thread cache_thread([id]() {
-        // open cache
-        Str filepath = get_persistent_filepath("likes_feed.json", true);
-        auto likes_registry = nlohmann::json();
-        try {
-            likes_registry = nlohmann::json::parse(std::ifstream(filepath.c_str()));
-
-        } catch (...) {
-            // ..
-        }
+    PEN_LOG("remove %s from likes registry", id.c_str());
+    likes_journal_remove(id.c_str());
 
-        if(likes_registry.contains(id.c_str())) {
-            likes_registry.erase(id.c_str());
-            increment_server_like(id, -1);
-            PEN_LOG("remove %s from likes registry", id.c_str());
-            FILE* fp = fopen(filepath.c_str(), "wb");
-            std::string j = likes_registry.dump();
-            fwrite(j.c_str(), j.length(), 1, fp);
-            fclose(fp);
-        }
+    std::thread like_thread([id]() {
+        increment_server_like(id, -1);
     });
-    cache_thread.detach();
+    like_thread.detach();
 }
 
 nlohmann::json get_likes()
@@ -5515,7 +8353,9 @@ void discogs_token_input()
         if(ImGui::Button("Log In"))
         {
             // validate the key and set
-            auto response = curl::discogs_request("GET", "https://api.discogs.com/oauth/identity", key_buf, nullptr);
+            Str discogs_identity_url = curl::discogs_api_url();
+            discogs_identity_url.append("/oauth/identity");
+            auto response = curl::discogs_request("GET", discogs_identity_url.c_str(), key_buf, nullptr);
             if(response.is_null())
             {
                 verify_message = "Token is incorrect or invalid";
@@ -6101,12 +8941,15 @@ void* data_cache_enumerate(void* userdata) {
 
         DirInfo ii = cached_releases[i];
         auto bn = str_basename(ii.path);
-        u32 bnh = PEN_HASH(bn.c_str());
+        u64 bnh = hash64(bn.c_str(), bn.length());
 
         bool remove = true;
-        if(view->release_pos.find(bnh) != view->release_pos.end()) {
-            remove = view->release_pos[bnh] > cache_range;
+        view->release_pos_mutex.lock();
+        u32* pos = view->release_pos.find(bnh);
+        if(pos) {
+            remove = *pos > cache_range;
         }
+        view->release_pos_mutex.unlock();
 
         if(remove) {
             cached_releases.erase(cached_releases.begin() + i);
@@ -6127,7 +8970,7 @@ void* data_cache_enumerate(void* userdata) {
     }
 
     // flag terminated. this thread makes a single pass and exits, the old scrolled distance
-    // re-trigger was dead code (top_pos is never written) and kept the thread alive forever,
+    // re-trigger was dead code and kept the thread alive forever,
     // which also blocked cleanup_views from ever freeing the view
     view->threads_terminated++;
     return nullptr;
@@ -6166,12 +9009,14 @@ Str append_auth(Str url) {
 
 void add_to_wants(Str discogs_username, u64 discogs_release_id) {
     Str url = "";
-    url.appendf("https://api.discogs.com/users/%s/wants/%llu", discogs_username.c_str(), discogs_release_id);
+    url.appendf("%s/users/%s/wants/%llu", curl::discogs_api_url(), discogs_username.c_str(), discogs_release_id);
     auto response = curl::discogs_request("PUT", url.c_str(), ctx.discogs_token.c_str(), "");
 }
 
 Str get_discogs_username(Str token) {
-    auto response = curl::discogs_request("GET", "https://api.discogs.com/oauth/identity", token.c_str(), nullptr);
+    Str discogs_identity_url = curl::discogs_api_url();
+    discogs_identity_url.append("/oauth/identity");
+    auto response = curl::discogs_request("GET", discogs_identity_url.c_str(), token.c_str(), nullptr);
     if(response.is_null())
     {
         return "";
@@ -124,7 +124,10 @@
 #include "ecs/ecs_scene.h"
 
 #include "json.hpp"
+#include "registry.h"
 #include <set>
+#include <deque>
+#include <condition_variable>
 
 using namespace put::ecs;
 
@@ -153,6 +156,7 @@ constexpr f32       k_text_size_small = 0.66f;
 constexpr f32       k_release_button_tap_radius_ratio = 64.0f / k_promax_11_w;
 constexpr f32       k_page_button_press_radius_ratio = 74.0f / k_promax_11_w;
 constexpr u32       k_num_threads_per_view = 4;
+constexpr u32       k_num_soa_readers = 2; // data_cache_fetch and data_loader park while the soa grows
 constexpr size_t    k_login_buf_size = 320;
 constexpr s32       k_ram_cache_range = 10;
 constexpr s32       k_disk_cache_min_range = 10;
@@ -178,25 +182,9 @@ namespace EntityFlags
     };
 }
 
+// store tag icons, the tags themselves are in registry.h
 namespace StoreTags
 {
-    enum StoreTags
-    {
-        preorder = 1<<0,
-        out_of_stock = 1<<1,
-        has_charted = 1<<2,
-        has_been_out_of_stock = 1<<3,
-        low_stock = 1<<4
-    };
-
-    const c8* names[] = {
-        "preorder",
-        "out_of_stock",
-        "has_charted",
-        "has_been_out_of_stock",
-        "low_stock"
-    };
-
     const c8* icons[] = {
         ICON_FA_CALENDAR_TIMES_O,
         ICON_FA_EXCLAMATION_TRIANGLE,
@@ -205,7 +193,6 @@ namespace StoreTags
         ICON_FA_THERMOMETER_QUARTER
     };
 }
-typedef u32 StoreTags_t;
 
 namespace Page
 {
@@ -248,19 +235,72 @@ namespace Status
 }
 typedef u32 Status_t;
 
+namespace CachePolicy
+{
+    enum CachePolicy
+    {
+        network_first,          // fetch, fall back to the cache file on failure
+        stale_while_revalidate, // serve the cache file immediately, the caller revalidates later
+        cache_only              // serve the cache file, fetch only when there is none
+    };
+}
+typedef u32 CachePolicy_t;
+
+namespace TransferCategory
+{
+    // what a network transfer was for, telemetry is grouped by it
+    enum TransferCategory
+    {
+        registry,
+        artwork,
+        audio,
+        discogs,
+        user_data,
+        count
+    };
+}
+typedef u32 TransferCategory_t;
+
+namespace AssetType
+{
+    // fetch priority order for assets at the same distance from the top release
+    enum AssetType
+    {
+        artwork,
+        selected_track,
+        track,
+        count
+    };
+}
+
+// immutable view of a string owned by the releases view, either in a mapped snapshot string table or an
+// in memory snapshot. soa text columns hold these so populating a view does no per field allocation
+struct StrView
+{
+    const c8* str = "";
+    u32       len = 0;
+
+    const c8* c_str() const { return str ? str : ""; }
+    u32       length() const { return len; }
+    bool      empty() const { return len == 0; }
+    bool      operator==(const c8* rhs) const { return strcmp(c_str(), rhs) == 0; }
+    bool      operator!=(const c8* rhs) const { return strcmp(c_str(), rhs) != 0; }
+    Str       to_str() const { return Str(c_str()); }
+};
+
 struct soa
 {
-    cmp_array<Str>                          key;
-    cmp_array<Str>                          id;
+    cmp_array<StrView>                      key;
+    cmp_array<StrView>                      id;
     cmp_array<u64>                          flags;
     cmp_array<std::atomic<u64>>             atomic_flags;
-    cmp_array<Str>                          artist;
-    cmp_array<Str>                          title;
-    cmp_array<Str>                          label;
-    cmp_array<Str>                          cat;
-    cmp_array<Str>                          link;
-    cmp_array<Str>                          label_link;
-    cmp_array<Str>                          artwork_url;
+    cmp_array<StrView>                      artist;
+    cmp_array<StrView>                      title;
+    cmp_array<StrView>                      label;
+    cmp_array<StrView>                      cat;
+    cmp_array<StrView>                      link;
+    cmp_array<StrView>                      label_link;
+    cmp_array<StrView>                      artwork_url;
     cmp_array<Str>                          artwork_filepath;
     cmp_array<u32>                          artwork_texture;
     cmp_array<pen::texture_creation_params> artwork_tcp;
@@ -275,20 +315,22 @@ struct soa
     cmp_array<f32>                          posy;
     cmp_array<f32>                          sizey;
     cmp_array<StoreTags_t>                  store_tags;
-    cmp_array<Str>                          store;
+    cmp_array<StrView>                      store;
     cmp_array<u32>                          like_count;
-    cmp_array<Str>                          discogs_url;
+    cmp_array<StrView>                      discogs_url;
     cmp_array<u64>                          discogs_id;
-    cmp_array<Str>                          resource_url;
+    cmp_array<StrView>                      resource_url;
     std::atomic<size_t>                     available_entries = {0};
     std::atomic<size_t>                     soa_size = {0};
 };
 
 struct AsyncDict
 {
-    std::mutex                  mutex;
-    nlohmann::json              dict;
-    std::atomic<Status_t>       status = { Status::e_not_initialised };
+    std::mutex                              mutex;
+    nlohmann::json                          dict;
+    std::atomic<Status_t>                   status = { Status::e_not_initialised };
+    bool                                    stale = false; // dict was served from cache and needs revalidating
+    std::shared_ptr<const nlohmann::json>   parsed = nullptr; // the parsed json cache entry dict is a copy of
 };
 
 struct DataContext
@@ -309,6 +351,28 @@ struct StoreView
     size_t              art_index = 0;
 };
 
+struct CacheFetchResult
+{
+    u32 index = 0;
+    s32  track = -1; // -1 for artwork
+    Str  filepath = "";
+    bool cancelled = false;
+};
+
+// a snapshot mapped from disk, or built in memory into buffer
+struct RegistrySnapshot : SnapshotTables
+{
+    void*                   mapped = nullptr;
+    size_t                  mapped_size = 0;
+    std::vector<u8>         buffer; // snapshots built in memory own their bytes
+
+    RegistrySnapshot() = default;
+    RegistrySnapshot(const RegistrySnapshot&) = delete;
+    ~RegistrySnapshot();
+
+    StrView view(const SnapshotString& s) const { return { strings + s.offset, s.length }; }
+};
+
 struct ReleasesView
 {
     soa                 releases = {};
@@ -318,19 +382,34 @@ struct ReleasesView
     StoreView           store_view = {};
     std::atomic<u32>    terminate = { 0 };
     std::atomic<u32>    threads_terminated = { 0 };
-    u32                 top_pos = 0;
+    std::atomic<s32>    top_pos = { 0 };
+    std::atomic<u32>    foreground = { 1 };
     vec2f               scroll = vec2f(0.0f, 0.0f);
     f32                 target_scroll_y = 0.0f;
     void*               thread_mem[k_num_threads_per_view] = {0};
-    std::map<u32, u32>  release_pos = {};
+    FlatHashMap<u32>    release_pos = {}; // chart position by hash64 of the release key
+    std::mutex          release_pos_mutex; // feed pages keep adding positions after release_pos_status is ready
     Status_t            release_pos_status = Status::e_not_initialised;
+    std::atomic<size_t> grow_size = { 0 }; // entries the loader needs added to the soa, grown on the main thread
+    std::atomic<u32>    readers_parked = { 0 };
+    std::mutex          grow_mutex; // guards the grow handshake and top_pos updates so waits on grow_cv can't miss a wake up
+    std::condition_variable grow_cv;
     u32                 request_id = 0;
+    CachePolicy_t       cache_policy = CachePolicy::stale_while_revalidate;
+    std::atomic<u32>    revalidated = { 0 }; // fresher data than what was populated is in the cache
+    std::atomic<f32>    populated_ms = { 0.0f }; // view creation until the first page was fully published
+    std::mutex                      fetch_mutex;
+    std::vector<CacheFetchResult>   fetch_results = {};
+    std::atomic<u32>                fetches_in_flight = { 0 };
+    std::deque<RegistrySnapshot>    snapshots; // backs the soa text columns, deque keeps them in place as pages arrive
 };
 
 struct ChartItem
 {
-    std::string index;
-    f64         pos;
+    std::string             index;
+    f64                     pos;
+    const RegistrySnapshot* snapshot = nullptr;
+    u32                     record = 0;
 };
 
 struct Store
@@ -431,7 +510,7 @@ void            audio_player_stop_existing();
 void            audio_player();
 
 // user / likes API
-bool            has_like(const Str& id);
+bool            has_like(const c8* id);
 void            add_like(const Str& id);
 f32             get_like_timestamp(const Str& id);
 void            remove_like(const Str& id);
@@ -0,0 +1,959 @@
+// registry.h
+// the registry data path shared by the app and the standalone benchmarks in app/tools/bench: 64 bit key
+// hashing and the flat hash map, the binary registry snapshot format with its builder, and the on demand
+// json reader which turns raw registry payloads into snapshots. it only needs types.h and json.hpp.
+
+#pragma once
+
+#include "types.h"
+#include "json.hpp"
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// simd string scans in the registry reader
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSON_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_SCAN_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define JSON_SCAN_NEON
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 64 bit fnv-1a, release keys and cache folder names are hashed with this for the flat hash indices
+inline u64 hash64(const c8* str, size_t len)
+{
+    u64 h = 0xcbf29ce484222325ull;
+    for(size_t i = 0; i < len; ++i) {
+        h ^= (u8)str[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+inline u64 hash64(const c8* str)
+{
+    return hash64(str, strlen(str));
+}
+
+// open addressing hash table with 64 bit keys and linear probing, keys and values are kept in flat arrays
+// so lookups touch a cache line or two. 0 marks an empty slot so a hash of 0 is stored as 1
+template<typename T>
+struct FlatHashMap
+{
+    std::vector<u64> keys;
+    std::vector<T>   values;
+    size_t           count = 0;
+
+    static u64 slot_key(u64 key) {
+        return key ? key : 1;
+    }
+
+    size_t probe(u64 key) const {
+        size_t mask = keys.size() - 1;
+        size_t i = (size_t)(key ^ (key >> 32)) & mask;
+        while(keys[i] != 0 && keys[i] != key) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    // keeps the load factor at or below a half
+    void reserve(size_t n) {
+        size_t capacity = 16;
+        while(capacity < n * 2) {
+            capacity *= 2;
+        }
+
+        if(capacity <= keys.size()) {
+            return;
+        }
+
+        std::vector<u64> old_keys;
+        std::vector<T> old_values;
+        old_keys.swap(keys);
+        old_values.swap(values);
+
+        keys.assign(capacity, 0);
+        values.resize(capacity);
+        for(size_t i = 0; i < old_keys.size(); ++i) {
+            if(old_keys[i] != 0) {
+                size_t slot = probe(old_keys[i]);
+                keys[slot] = old_keys[i];
+                values[slot] = old_values[i];
+            }
+        }
+    }
+
+    T* find(u64 key) {
+        if(count == 0) {
+            return nullptr;
+        }
+
+        key = slot_key(key);
+        size_t slot = probe(key);
+        return keys[slot] == key ? &values[slot] : nullptr;
+    }
+
+    // returns false and leaves the value alone if the key is already present
+    bool insert(u64 key, const T& value) {
+        reserve(count + 1);
+        key = slot_key(key);
+        size_t slot = probe(key);
+        if(keys[slot] == key) {
+            return false;
+        }
+
+        keys[slot] = key;
+        values[slot] = value;
+        count++;
+        return true;
+    }
+
+    T& operator[](u64 key) {
+        reserve(count + 1);
+        key = slot_key(key);
+        size_t slot = probe(key);
+        if(keys[slot] != key) {
+            keys[slot] = key;
+            values[slot] = T();
+            count++;
+        }
+        return values[slot];
+    }
+};
+
+// store tags carried by releases, the bit is the index into names
+namespace StoreTags
+{
+    enum StoreTags
+    {
+        preorder = 1<<0,
+        out_of_stock = 1<<1,
+        has_charted = 1<<2,
+        has_been_out_of_stock = 1<<3,
+        low_stock = 1<<4
+    };
+
+    const c8* names[] = {
+        "preorder",
+        "out_of_stock",
+        "has_charted",
+        "has_been_out_of_stock",
+        "low_stock"
+    };
+}
+typedef u32 StoreTags_t;
+
+// binary registry snapshot: a header, fixed width release records sorted by chart position, string refs
+// for the per release arrays (artworks, track names and urls) and a shared null terminated string table
+constexpr u32 k_snapshot_magic = 0x50414e53; // SNAP
+constexpr u32 k_snapshot_version = 1;
+
+struct SnapshotString
+{
+    u32 offset;
+    u32 length;
+};
+
+struct SnapshotHeader
+{
+    u32 magic;
+    u32 version;
+    u32 record_count;
+    u32 ref_count;
+    u32 string_table_size;
+    u32 pad[3];
+};
+
+struct SnapshotRecord
+{
+    SnapshotString  key;
+    SnapshotString  id;
+    SnapshotString  artist;
+    SnapshotString  title;
+    SnapshotString  link;
+    SnapshotString  label;
+    SnapshotString  cat;
+    SnapshotString  store;
+    SnapshotString  label_link;
+    SnapshotString  discogs_url;
+    SnapshotString  resource_url;
+    u64             discogs_id;
+    f64             pos;
+    u32             like_count;
+    u32             store_tags;
+    u32             artworks_first;
+    u32             artworks_count;
+    u32             track_names_first;
+    u32             track_names_count;
+    u32             track_urls_first;
+    u32             track_urls_count;
+};
+
+// the sections of a snapshot, pointing into its bytes
+struct SnapshotTables
+{
+    const SnapshotHeader*   header = nullptr;
+    const SnapshotRecord*   records = nullptr;
+    const SnapshotString*   refs = nullptr;
+    const c8*               strings = nullptr;
+
+    const c8* str(const SnapshotString& s) const { return strings + s.offset; }
+};
+
+// records, refs and the deduplicated string table of a snapshot as it is built
+struct SnapshotBuilder
+{
+    std::vector<SnapshotRecord>             records;
+    std::vector<SnapshotString>             refs;
+    std::vector<c8>                         strings;
+    FlatHashMap<SnapshotString>             string_lookup;
+
+    // strings are shared, labels and store names repeat across most releases. a hash collision just
+    // stores the string again
+    SnapshotString add_string(const c8* str, size_t len) {
+        u64 h = hash64(str, len);
+        SnapshotString* found = string_lookup.find(h);
+        if(found && found->length == len && memcmp(strings.data() + found->offset, str, len) == 0) {
+            return *found;
+        }
+
+        SnapshotString ss = { (u32)strings.size(), (u32)len };
+        strings.insert(strings.end(), str, str + len);
+        strings.push_back('\0');
+        if(!found) {
+            string_lookup.insert(h, ss);
+        }
+        return ss;
+    }
+
+    SnapshotString add_string(const std::string& str) {
+        return add_string(str.data(), str.length());
+    }
+
+    // string fields default to "" and discogs_id to -1, the same as a release missing them
+    void init_record(SnapshotRecord& record) {
+        static const std::string empty;
+        SnapshotString es = add_string(empty);
+        record = {};
+        record.key = es;
+        record.id = es;
+        record.artist = es;
+        record.title = es;
+        record.link = es;
+        record.label = es;
+        record.cat = es;
+        record.store = es;
+        record.label_link = es;
+        record.resource_url = es;
+        record.discogs_url = es;
+        record.discogs_id = -1;
+    }
+
+    void write(std::vector<u8>& out) {
+        SnapshotHeader header = {};
+        header.magic = k_snapshot_magic;
+        header.version = k_snapshot_version;
+        header.record_count = (u32)records.size();
+        header.ref_count = (u32)refs.size();
+        header.string_table_size = (u32)strings.size();
+
+        size_t records_size = records.size() * sizeof(SnapshotRecord);
+        size_t refs_size = refs.size() * sizeof(SnapshotString);
+
+        out.resize(sizeof(SnapshotHeader) + records_size + refs_size + strings.size());
+        u8* dst = out.data();
+        memcpy(dst, &header, sizeof(SnapshotHeader));
+        dst += sizeof(SnapshotHeader);
+        memcpy(dst, records.data(), records_size);
+        dst += records_size;
+        memcpy(dst, refs.data(), refs_size);
+        dst += refs_size;
+        memcpy(dst, strings.data(), strings.size());
+    }
+};
+
+// builds a snapshot from a registry dict. with index_on the records carry that chart position and are sorted
+// by it, otherwise they keep the dict order
+inline void build_registry_snapshot(const nlohmann::json& dict, const c8* index_on, std::vector<u8>& out)
+{
+    SnapshotBuilder builder;
+
+    // fields are read by reference, a single lookup each and no string copies on the way to the table
+    static const std::string empty;
+    auto field = [&](const nlohmann::json& j, const c8* key) {
+        auto it = j.find(key);
+        if(it != j.end() && it->is_string()) {
+            return builder.add_string(it->get_ref<const std::string&>());
+        }
+        return builder.add_string(empty);
+    };
+
+    auto add_refs = [&](const nlohmann::json& j, const c8* key, u32& first, u32& count) {
+        first = (u32)builder.refs.size();
+        count = 0;
+        auto it = j.find(key);
+        if(it != j.end() && it->is_array()) {
+            for(auto& item : *it) {
+                builder.refs.push_back(builder.add_string(item.is_string() ? item.get_ref<const std::string&>() : empty));
+                count++;
+            }
+        }
+    };
+
+    for(auto& item : dict.items()) {
+        auto& release = item.value();
+        if(!release.is_object()) {
+            continue;
+        }
+
+        SnapshotRecord record = {};
+        record.key = builder.add_string(item.key());
+        record.id = field(release, "id");
+        record.artist = field(release, "artist");
+        record.title = field(release, "title");
+        record.link = field(release, "link");
+        record.label = field(release, "label");
+        record.cat = field(release, "cat");
+        record.store = field(release, "store");
+        record.label_link = field(release, "label_link");
+        record.resource_url = field(release, "resource_url");
+
+        // discogs info
+        record.discogs_url = builder.add_string(empty);
+        record.discogs_id = -1;
+        if(release.contains("discogs")) {
+            auto& discogs = release["discogs"];
+            record.discogs_url = field(discogs, "url");
+            if(discogs.contains("id") && discogs["id"].is_number()) {
+                record.discogs_id = discogs["id"].get<int>();
+            }
+        }
+
+        // likes
+        if(release.contains("likes") && release["likes"].contains("count") && release["likes"]["count"].is_number()) {
+            record.like_count = release["likes"]["count"].get<int>();
+        }
+
+        // store tags
+        if(release.contains("store_tags")) {
+            auto& tags = release["store_tags"];
+            for(u32 t = 0; t < PEN_ARRAY_SIZE(StoreTags::names); ++t) {
+                if(tags.contains(StoreTags::names[t]) && tags[StoreTags::names[t]].is_boolean() && tags[StoreTags::names[t]]) {
+                    record.store_tags |= (1<<t);
+                }
+            }
+        }
+
+        if(index_on && release.contains(index_on) && release[index_on].is_number()) {
+            record.pos = release[index_on].get<f64>();
+        }
+
+        add_refs(release, "artworks", record.artworks_first, record.artworks_count);
+        add_refs(release, "track_names", record.track_names_first, record.track_names_count);
+        add_refs(release, "track_urls", record.track_urls_first, record.track_urls_count);
+
+        builder.records.push_back(record);
+    }
+
+    if(index_on) {
+        std::stable_sort(begin(builder.records),end(builder.records),[](const SnapshotRecord& a, const SnapshotRecord& b) {return a.pos < b.pos; });
+    }
+
+    builder.write(out);
+}
+
+// on demand reader for registry payloads. the release schema is known so the raw json is walked once and
+// the fields a snapshot needs go straight into its string table, nothing else is materialised. the
+// string scans, where most of the bytes are, test 16 or 32 bytes at a time where simd is available
+inline u32 json_ctz(u64 v)
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return (u32)i;
+#else
+    return (u32)__builtin_ctzll(v);
+#endif
+}
+
+// first '"' or '\\' at or after p, end when there is none
+inline const c8* json_scan_string(const c8* p, const c8* end)
+{
+#if defined(JSON_SCAN_AVX2)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+    while(end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash)));
+        if(mask) {
+            return p + json_ctz(mask);
+        }
+        p += 32;
+    }
+#elif defined(JSON_SCAN_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('\\');
+    while(end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)));
+        if(mask) {
+            return p + json_ctz(mask);
+        }
+        p += 16;
+    }
+#elif defined(JSON_SCAN_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t slash = vdupq_n_u8('\\');
+    while(end - p >= 16) {
+        uint8x16_t v = vld1q_u8((const u8*)p);
+        uint8x16_t m = vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, slash));
+        // narrow to a nibble per byte to get a movemask
+        u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+        if(mask) {
+            return p + (json_ctz(mask) >> 2);
+        }
+        p += 16;
+    }
+#endif
+    while(p < end && *p != '"' && *p != '\\') {
+        ++p;
+    }
+    return p;
+}
+
+struct JsonReader
+{
+    const c8* p;
+    const c8* end;
+    bool      error = false;
+
+    void ws() {
+        while(p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+            ++p;
+        }
+    }
+
+    bool peek(c8 c) {
+        ws();
+        return p < end && *p == c;
+    }
+
+    bool expect(c8 c) {
+        ws();
+        if(p < end && *p == c) {
+            ++p;
+            return true;
+        }
+        error = true;
+        return false;
+    }
+
+    // after a member or element, true when there is another one
+    bool next(c8 close) {
+        ws();
+        if(p < end && *p == ',') {
+            ++p;
+            return true;
+        }
+        if(p < end && *p == close) {
+            ++p;
+            return false;
+        }
+        error = true;
+        return false;
+    }
+
+    bool hex4(u32& cp) {
+        if(end - p < 4) {
+            return false;
+        }
+        cp = 0;
+        for(u32 i = 0; i < 4; ++i) {
+            c8 c = p[i];
+            cp <<= 4;
+            if(c >= '0' && c <= '9') cp |= c - '0';
+            else if(c >= 'a' && c <= 'f') cp |= c - 'a' + 10;
+            else if(c >= 'A' && c <= 'F') cp |= c - 'A' + 10;
+            else return false;
+        }
+        p += 4;
+        return true;
+    }
+
+    // reads a string in place when it has no escapes, otherwise decodes it into scratch
+    bool string_ref(const c8*& str, size_t& len, std::string& scratch) {
+        ws();
+        if(p < end && *p == '"') {
+            const c8* run = json_scan_string(p + 1, end);
+            if(run < end && *run == '"') {
+                str = p + 1;
+                len = run - str;
+                p = run + 1;
+                return true;
+            }
+        }
+
+        if(!string(&scratch)) {
+            return false;
+        }
+        str = scratch.data();
+        len = scratch.length();
+        return true;
+    }
+
+    // decodes a string into out, or skips it when out is null
+    bool string(std::string* out) {
+        if(out) {
+            out->clear();
+        }
+
+        if(!expect('"')) {
+            return false;
+        }
+
+        for(;;) {
+            const c8* run = json_scan_string(p, end);
+            if(out) {
+                out->append(p, run - p);
+            }
+            p = run;
+
+            if(p >= end) {
+                error = true;
+                return false;
+            }
+
+            if(*p == '"') {
+                ++p;
+                return true;
+            }
+
+            // escape
+            if(end - p < 2) {
+                error = true;
+                return false;
+            }
+
+            c8 e = p[1];
+            p += 2;
+
+            c8 c = 0;
+            switch(e) {
+                case '"': c = '"'; break;
+                case '\\': c = '\\'; break;
+                case '/': c = '/'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    u32 cp = 0;
+                    if(!hex4(cp)) {
+                        error = true;
+                        return false;
+                    }
+
+                    // surrogate pair
+                    if(cp >= 0xd800 && cp <= 0xdbff) {
+                        u32 lo = 0;
+                        if(end - p < 2 || p[0] != '\\' || p[1] != 'u') {
+                            error = true;
+                            return false;
+                        }
+                        p += 2;
+                        if(!hex4(lo) || lo < 0xdc00 || lo > 0xdfff) {
+                            error = true;
+                            return false;
+                        }
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                    }
+
+                    if(out) {
+                        if(cp < 0x80) {
+                            out->push_back((c8)cp);
+                        }
+                        else if(cp < 0x800) {
+                            out->push_back((c8)(0xc0 | (cp >> 6)));
+                            out->push_back((c8)(0x80 | (cp & 0x3f)));
+                        }
+                        else if(cp < 0x10000) {
+                            out->push_back((c8)(0xe0 | (cp >> 12)));
+                            out->push_back((c8)(0x80 | ((cp >> 6) & 0x3f)));
+                            out->push_back((c8)(0x80 | (cp & 0x3f)));
+                        }
+                        else {
+                            out->push_back((c8)(0xf0 | (cp >> 18)));
+                            out->push_back((c8)(0x80 | ((cp >> 12) & 0x3f)));
+                            out->push_back((c8)(0x80 | ((cp >> 6) & 0x3f)));
+                            out->push_back((c8)(0x80 | (cp & 0x3f)));
+                        }
+                    }
+                    continue;
+                }
+                default:
+                    error = true;
+                    return false;
+            }
+
+            if(out) {
+                out->push_back(c);
+            }
+        }
+    }
+
+    // number, true, false or null. returns false without consuming anything for other values
+    bool scalar(f64* number, bool* boolean) {
+        ws();
+        const c8* start = p;
+        while(p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') {
+            ++p;
+        }
+
+        size_t len = p - start;
+        if(len == 4 && strncmp(start, "true", 4) == 0) {
+            if(boolean) *boolean = true;
+            return true;
+        }
+        if(len == 5 && strncmp(start, "false", 5) == 0) {
+            if(boolean) *boolean = false;
+            return true;
+        }
+        if(len == 4 && strncmp(start, "null", 4) == 0) {
+            return true;
+        }
+
+        c8 buf[64];
+        if(len > 0 && len < sizeof(buf) && (*start == '-' || (*start >= '0' && *start <= '9'))) {
+            memcpy(buf, start, len);
+            buf[len] = '\0';
+            c8* num_end = nullptr;
+            f64 v = strtod(buf, &num_end);
+            if(num_end == buf + len) {
+                if(number) *number = v;
+                return true;
+            }
+        }
+
+        p = start;
+        error = true;
+        return false;
+    }
+
+    bool skip_value() {
+        ws();
+        if(p >= end) {
+            error = true;
+            return false;
+        }
+
+        if(*p == '"') {
+            return string(nullptr);
+        }
+
+        if(*p == '{' || *p == '[') {
+            u32 depth = 0;
+            while(p < end) {
+                c8 c = *p;
+                if(c == '"') {
+                    if(!string(nullptr)) {
+                        return false;
+                    }
+                    continue;
+                }
+
+                ++p;
+                if(c == '{' || c == '[') {
+                    depth++;
+                }
+                else if(c == '}' || c == ']') {
+                    if(--depth == 0) {
+                        return true;
+                    }
+                }
+            }
+            error = true;
+            return false;
+        }
+
+        return scalar(nullptr, nullptr);
+    }
+};
+
+// reads one release object into record, fields are interpreted the same way build_registry_snapshot does
+// and the ones the snapshot doesn't carry are skipped without decoding
+inline bool read_release(JsonReader& r, SnapshotBuilder& builder, const c8* index_on, SnapshotRecord& record, std::string& scratch)
+{
+    struct StringField {
+        const c8*       name;
+        SnapshotString  SnapshotRecord::* member;
+    };
+
+    static const StringField k_string_fields[] = {
+        {"id", &SnapshotRecord::id},
+        {"artist", &SnapshotRecord::artist},
+        {"title", &SnapshotRecord::title},
+        {"link", &SnapshotRecord::link},
+        {"label", &SnapshotRecord::label},
+        {"cat", &SnapshotRecord::cat},
+        {"store", &SnapshotRecord::store},
+        {"label_link", &SnapshotRecord::label_link},
+        {"resource_url", &SnapshotRecord::resource_url}
+    };
+
+    // adds the string at the cursor to the table
+    auto read_string = [&](SnapshotString& ss) {
+        const c8* str = nullptr;
+        size_t len = 0;
+        if(!r.string_ref(str, len, scratch)) {
+            return false;
+        }
+        ss = builder.add_string(str, len);
+        return true;
+    };
+
+    auto read_refs = [&](u32& first, u32& count) {
+        first = (u32)builder.refs.size();
+        count = 0;
+        if(!r.peek('[')) {
+            return r.skip_value();
+        }
+
+        r.expect('[');
+        if(r.peek(']')) {
+            return r.expect(']');
+        }
+
+        do {
+            SnapshotString ss = {};
+            if(r.peek('"')) {
+                if(!read_string(ss)) {
+                    return false;
+                }
+            }
+            else {
+                if(!r.skip_value()) {
+                    return false;
+                }
+                ss = builder.add_string("", 0);
+            }
+            builder.refs.push_back(ss);
+            count++;
+        } while(r.next(']'));
+
+        return !r.error;
+    };
+
+    // iterates the members of an object value, anything else is skipped
+    auto members = [&](auto member) {
+        if(!r.peek('{')) {
+            return r.skip_value();
+        }
+
+        r.expect('{');
+        if(r.peek('}')) {
+            return r.expect('}');
+        }
+
+        std::string key;
+        do {
+            if(!r.string(&key) || !r.expect(':') || !member(key)) {
+                return false;
+            }
+        } while(r.next('}'));
+
+        return !r.error;
+    };
+
+    return members([&](const std::string& name) {
+        for(auto& field : k_string_fields) {
+            if(name == field.name) {
+                if(r.peek('"')) {
+                    return read_string(record.*field.member);
+                }
+                return r.skip_value();
+            }
+        }
+
+        if(name == "discogs") {
+            return members([&](const std::string& key) {
+                if(key == "url" && r.peek('"')) {
+                    return read_string(record.discogs_url);
+                }
+
+                f64 id = 0.0;
+                if(key == "id" && !r.peek('"') && !r.peek('{') && !r.peek('[')) {
+                    if(r.scalar(&id, nullptr)) {
+                        record.discogs_id = (int)id;
+                        return true;
+                    }
+                    return false;
+                }
+                return r.skip_value();
+            });
+        }
+
+        if(name == "likes") {
+            return members([&](const std::string& key) {
+                f64 count = 0.0;
+                if(key == "count" && !r.peek('"') && !r.peek('{') && !r.peek('[')) {
+                    if(r.scalar(&count, nullptr)) {
+                        record.like_count = (int)count;
+                        return true;
+                    }
+                    return false;
+                }
+                return r.skip_value();
+            });
+        }
+
+        if(name == "store_tags") {
+            return members([&](const std::string& key) {
+                for(u32 t = 0; t < PEN_ARRAY_SIZE(StoreTags::names); ++t) {
+                    if(key == StoreTags::names[t] && !r.peek('"') && !r.peek('{') && !r.peek('[')) {
+                        bool tag = false;
+                        if(!r.scalar(nullptr, &tag)) {
+                            return false;
+                        }
+                        if(tag) {
+                            record.store_tags |= (1<<t);
+                        }
+                        return true;
+                    }
+                }
+                return r.skip_value();
+            });
+        }
+
+        if(index_on && name == index_on && !r.peek('"') && !r.peek('{') && !r.peek('[')) {
+            return r.scalar(&record.pos, nullptr);
+        }
+
+        if(name == "artworks") {
+            return read_refs(record.artworks_first, record.artworks_count);
+        }
+
+        if(name == "track_names") {
+            return read_refs(record.track_names_first, record.track_names_count);
+        }
+
+        if(name == "track_urls") {
+            return read_refs(record.track_urls_first, record.track_urls_count);
+        }
+
+        return r.skip_value();
+    });
+}
+
+// builds a snapshot from raw registry json without parsing it into a dict, the result matches
+// build_registry_snapshot on the parsed dict. returns false for malformed json or a firebase error
+inline bool read_registry_snapshot(const c8* data, size_t size, const c8* index_on, std::vector<u8>& out)
+{
+    JsonReader r = { data, data + size };
+    SnapshotBuilder builder;
+    std::string key;
+    std::string scratch;
+
+    // allow the null terminator of a download buffer
+    while(r.end > r.p && r.end[-1] == '\0') {
+        r.end--;
+    }
+
+    // an empty query or a missing path comes back as null
+    if(!r.peek('{')) {
+        if(!r.scalar(nullptr, nullptr)) {
+            return false;
+        }
+    }
+    else {
+        r.expect('{');
+        if(r.peek('}')) {
+            r.expect('}');
+        }
+        else {
+            do {
+                if(!r.string(&key) || !r.expect(':')) {
+                    return false;
+                }
+
+                if(key == "error") {
+                    return false;
+                }
+
+                // null entries are removed releases
+                if(!r.peek('{')) {
+                    if(!r.skip_value()) {
+                        return false;
+                    }
+                    continue;
+                }
+
+                SnapshotRecord record;
+                builder.init_record(record);
+                record.key = builder.add_string(key);
+                if(!read_release(r, builder, index_on, record, scratch)) {
+                    return false;
+                }
+                builder.records.push_back(record);
+
+            } while(r.next('}'));
+        }
+    }
+
+    r.ws();
+    if(r.error || r.p != r.end) {
+        return false;
+    }
+
+    // dicts iterate in key order, so sort by key to match before ordering by position
+    const c8* strings = builder.strings.data();
+    std::sort(begin(builder.records),end(builder.records),[strings](const SnapshotRecord& a, const SnapshotRecord& b) {
+        return strcmp(strings + a.key.offset, strings + b.key.offset) < 0;
+    });
+
+    if(index_on) {
+        std::stable_sort(begin(builder.records),end(builder.records),[](const SnapshotRecord& a, const SnapshotRecord& b) {return a.pos < b.pos; });
+    }
+
+    builder.write(out);
+    return true;
+}
+
+// points the snapshot into data after checking the sections fit, no parsing happens here
+inline bool fixup_registry_snapshot(SnapshotTables& snapshot, const u8* data, size_t size)
+{
+    if(size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    auto header = (const SnapshotHeader*)data;
+    if(header->magic != k_snapshot_magic || header->version != k_snapshot_version) {
+        return false;
+    }
+
+    size_t expected = sizeof(SnapshotHeader)
+        + (size_t)header->record_count * sizeof(SnapshotRecord)
+        + (size_t)header->ref_count * sizeof(SnapshotString)
+        + header->string_table_size;
+
+    if(expected != size || (header->string_table_size > 0 && data[size - 1] != '\0')) {
+        return false;
+    }
+
+    snapshot.header = header;
+    snapshot.records = (const SnapshotRecord*)(data + sizeof(SnapshotHeader));
+    snapshot.refs = (const SnapshotString*)(snapshot.records + header->record_count);
+    snapshot.strings = (const c8*)(snapshot.refs + header->ref_count);
+    return true;
+}
@@ -0,0 +1,131 @@
+// curl::write_function growth strategies, fed multi mb bodies in 16kb chunks like libcurl delivers them.
+// old is the exact size realloc per callback the client used to do, geometric is the current doubling,
+// presized adds the Content-Length first write and pooled recycles the blocks between bodies the way
+// curl::release_buffer does. reallocs counts calls into the allocator, copied counts the bytes an allocator
+// which can't grow in place would have to move.
+// build:
+//   g++ -O2 -std=c++17 buffer_bench.cpp -o buffer_bench
+// run:
+//   ./buffer_bench
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+typedef unsigned char u8;
+
+constexpr size_t k_min_alloc = 1024;
+constexpr size_t k_chunk_size = 16 * 1024;
+
+struct DataBuffer {
+    u8*     data = nullptr;
+    size_t  size = 0;
+    size_t  alloc_size = 0;
+};
+
+struct Counters {
+    size_t  reallocs = 0;
+    size_t  copied = 0;
+};
+
+enum Strategy {
+    old_exact,
+    geometric,
+    presized,
+    pooled
+};
+
+const char* k_strategy_names[] = {"old", "geometric", "presized", "pooled"};
+
+// single slot pool, the loaders fetch one body at a time per thread
+std::vector<DataBuffer> s_pool;
+
+void grow(DataBuffer* db, size_t size, Counters& c)
+{
+    if(!db->data && !s_pool.empty()) {
+        auto best = std::find_if(s_pool.begin(), s_pool.end(), [size](const DataBuffer& b) { return b.alloc_size >= size; });
+        if(best != s_pool.end()) {
+            db->data = best->data;
+            db->alloc_size = best->alloc_size;
+            s_pool.erase(best);
+            return;
+        }
+    }
+
+    c.reallocs++;
+    c.copied += db->size;
+    db->data = (u8*)realloc(db->data, size);
+    db->alloc_size = size;
+}
+
+void write(DataBuffer* db, const u8* ptr, size_t len, size_t content_length, Strategy s, Counters& c)
+{
+    size_t required_size = db->size + len;
+    if(required_size >= db->alloc_size)
+    {
+        size_t new_alloc_size = std::max(required_size + 1, k_min_alloc + 1);
+        if(s != old_exact) {
+            new_alloc_size = std::max(new_alloc_size, db->alloc_size * 2);
+        }
+
+        if((s == presized || s == pooled) && db->alloc_size == 0) {
+            new_alloc_size = std::max(new_alloc_size, content_length + 1);
+        }
+
+        grow(db, new_alloc_size, c);
+    }
+
+    memcpy(db->data + db->size, ptr, len);
+    db->size = required_size;
+    db->data[required_size] = '\0';
+}
+
+void release(DataBuffer& db, Strategy s)
+{
+    if(s == pooled && s_pool.size() < 8) {
+        s_pool.push_back({db.data, 0, db.alloc_size});
+    }
+    else {
+        free(db.data);
+    }
+    db = {};
+}
+
+int main(int argc, char** argv)
+{
+    const size_t sizes[] = {1 << 20, 4 << 20, 16 << 20};
+    const int bodies = 20;
+
+    std::vector<u8> chunk(k_chunk_size, 'x');
+    printf("%-10s %8s %12s %14s %12s\n", "strategy", "body", "reallocs", "copied", "ms/body");
+    for(size_t body_size : sizes)
+    {
+        for(int s = old_exact; s <= pooled; ++s)
+        {
+            Counters c;
+            auto start = std::chrono::steady_clock::now();
+            for(int b = 0; b < bodies; ++b)
+            {
+                DataBuffer db;
+                for(size_t fed = 0; fed < body_size; fed += k_chunk_size) {
+                    write(&db, chunk.data(), std::min(k_chunk_size, body_size - fed), body_size, (Strategy)s, c);
+                }
+                release(db, (Strategy)s);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            printf("%-10s %6zuMB %12.1f %12.1fMB %12.3f\n",
+                k_strategy_names[s], body_size >> 20,
+                (double)c.reallocs / bodies, (double)c.copied / bodies / (1 << 20), ms / bodies);
+        }
+
+        for(auto& b : s_pool) {
+            free(b.data);
+        }
+        s_pool.clear();
+    }
+
+    return 0;
+}
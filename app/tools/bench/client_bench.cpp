@@ -0,0 +1,179 @@
+// cold vs warm request latency of the curl client against the firebase stand-in, over https.
+// cold is the old per request curl_easy_init / curl_easy_cleanup, warm is the client in main.cpp: easy handles
+// recycled through a pool with curl_easy_reset, attached to a share for dns and tls sessions.
+// build:
+//   g++ -O2 -std=c++17 client_bench.cpp -lcurl -lpthread -o client_bench
+// run against a stand-in with no added latency, so only connection setup is measured:
+//   openssl req -x509 -newkey rsa:2048 -nodes -subj /CN=localhost -keyout standin.key -out standin.crt
+//   python3 ../firebase_standin.py -port 8443 -latency 0 -cdn_latency 0 -cert standin.crt -key standin.key
+//   ./client_bench https://localhost:8443 200 4
+#include <curl/curl.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+struct Client {
+    CURLSH*             share = nullptr;
+    std::mutex          share_locks[CURL_LOCK_DATA_LAST];
+    std::mutex          pool_mutex;
+    std::vector<CURL*>  pool;
+};
+Client s_client;
+
+void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+    s_client.share_locks[data].lock();
+}
+
+void share_unlock(CURL* handle, curl_lock_data data, void* userptr)
+{
+    s_client.share_locks[data].unlock();
+}
+
+CURL* acquire_handle()
+{
+    CURL* curl = nullptr;
+
+    s_client.pool_mutex.lock();
+    if(!s_client.pool.empty()) {
+        curl = s_client.pool.back();
+        s_client.pool.pop_back();
+    }
+    s_client.pool_mutex.unlock();
+
+    if(!curl) {
+        curl = curl_easy_init();
+    }
+
+    curl_easy_setopt(curl, CURLOPT_SHARE, s_client.share);
+    return curl;
+}
+
+void release_handle(CURL* curl)
+{
+    curl_easy_reset(curl);
+
+    s_client.pool_mutex.lock();
+    s_client.pool.push_back(curl);
+    s_client.pool_mutex.unlock();
+}
+
+size_t discard(void* ptr, size_t size, size_t nmemb, void* userdata)
+{
+    return size * nmemb;
+}
+
+// one GET, returns the wall time in ms or a negative value on failure
+double get(CURL* curl, const std::string& url)
+{
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    auto start = std::chrono::steady_clock::now();
+    CURLcode res = curl_easy_perform(curl);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if(res != CURLE_OK) {
+        fprintf(stderr, "%s: %s\n", url.c_str(), curl_easy_strerror(res));
+        return -1.0;
+    }
+
+    return ms;
+}
+
+// a feed's worth of requests: a registry query then artwork, spread over workers like the loaders
+std::vector<double> run(const std::string& base, int requests, int workers, bool warm)
+{
+    std::vector<double> times(requests, 0.0);
+    std::vector<std::thread> threads;
+    for(int w = 0; w < workers; ++w)
+    {
+        threads.push_back(std::thread([&, w]() {
+            for(int i = w; i < requests; i += workers)
+            {
+                std::string url = base;
+                if(i % 8 == 0) {
+                    url += "/stores.json";
+                }
+                else {
+                    url += "/cdn/bench/artwork-" + std::to_string(i) + ".png";
+                }
+
+                if(warm) {
+                    CURL* curl = acquire_handle();
+                    times[i] = get(curl, url);
+                    release_handle(curl);
+                }
+                else {
+                    CURL* curl = curl_easy_init();
+                    times[i] = get(curl, url);
+                    curl_easy_cleanup(curl);
+                }
+            }
+        }));
+    }
+
+    for(auto& t : threads) {
+        t.join();
+    }
+
+    return times;
+}
+
+void report(const char* name, std::vector<double> times, double total_ms)
+{
+    size_t failed = std::count_if(times.begin(), times.end(), [](double t) { return t < 0.0; });
+    times.erase(std::remove_if(times.begin(), times.end(), [](double t) { return t < 0.0; }), times.end());
+    std::sort(times.begin(), times.end());
+    if(times.empty()) {
+        printf("%-6s all %zu requests failed\n", name, failed);
+        return;
+    }
+
+    double sum = 0.0;
+    for(double t : times) {
+        sum += t;
+    }
+
+    printf("%-6s requests %zu failed %zu mean %.2fms p50 %.2fms p95 %.2fms total %.1fms\n",
+        name, times.size(), failed, sum / times.size(), times[times.size() / 2], times[(times.size() * 95) / 100], total_ms);
+}
+
+int main(int argc, char** argv)
+{
+    std::string base = argc > 1 ? argv[1] : "https://localhost:8443";
+    int requests = argc > 2 ? atoi(argv[2]) : 200;
+    int workers = argc > 3 ? atoi(argv[3]) : 4;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    s_client.share = curl_share_init();
+    curl_share_setopt(s_client.share, CURLSHOPT_LOCKFUNC, share_lock);
+    curl_share_setopt(s_client.share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    curl_share_setopt(s_client.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(s_client.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    for(int pass = 0; pass < 2; ++pass)
+    {
+        bool warm = pass == 1;
+        auto start = std::chrono::steady_clock::now();
+        auto times = run(base, requests, workers, warm);
+        double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        report(warm ? "warm" : "cold", times, total);
+    }
+
+    for(auto* curl : s_client.pool) {
+        curl_easy_cleanup(curl);
+    }
+    curl_share_cleanup(s_client.share);
+    curl_global_cleanup();
+    return 0;
+}
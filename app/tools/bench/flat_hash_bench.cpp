@@ -0,0 +1,265 @@
+// release indices, the std::map ones the loaders used before (added_map keyed by std::string, release_pos by
+// a 32 bit hash) vs FlatHashMap keyed by hash64. two workloads: merging every section index of a multi section
+// view into the chart the way releases_view_loader's merge_records does, and the data_cache_enumerate sweep
+// probing release_pos for each cached release folder. the sections are fetched once from the stand-in and
+// read into snapshots, only the index work is timed. a 32 bit fnv-1a stands in for PEN_HASH.
+// build:
+//   g++ -O2 -std=c++17 -I../../code -I../../pmtech/core/pen/include flat_hash_bench.cpp -lcurl -o flat_hash_bench
+// run against a stand-in big enough that a juno view has 10k releases across its 5 sections:
+//   python3 ../firebase_standin.py -port 8091 -releases 47500 -latency 0
+//   ./flat_hash_bench http://localhost:8091 juno new_releases 20000
+#include <curl/curl.h>
+#include "registry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <chrono>
+
+size_t append(void* ptr, size_t size, size_t nmemb, std::string* body)
+{
+    body->append((const char*)ptr, size * nmemb);
+    return size * nmemb;
+}
+
+bool fetch(const std::string& url, std::string& body)
+{
+    CURL* curl = curl_easy_init();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, append);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    return res == CURLE_OK;
+}
+
+u32 hash32(const c8* str)
+{
+    u32 h = 0x811c9dc5u;
+    while(*str) {
+        h ^= (u8)*str++;
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+struct ChartItem
+{
+    std::string index;
+    f64         pos;
+    u32         record;
+};
+
+struct MapIndices
+{
+    std::map<std::string, size_t>   added_map;
+    std::map<u32, u32>              release_pos;
+};
+
+struct FlatIndices
+{
+    FlatHashMap<size_t>             added_map;
+    FlatHashMap<u32>                release_pos;
+};
+
+void merge_map(const SnapshotTables& snapshot, MapIndices& indices, std::vector<ChartItem>& view_chart)
+{
+    for(u32 r = 0; r < snapshot.header->record_count; ++r)
+    {
+        const SnapshotRecord& record = snapshot.records[r];
+        std::string key = snapshot.str(record.key);
+
+        if(indices.added_map.find(key) != indices.added_map.end()) {
+            auto vp = indices.added_map[key];
+            view_chart[vp].pos = std::min<u32>((u32)record.pos, (u32)view_chart[vp].pos);
+
+            u32 hh = hash32(key.c_str());
+            indices.release_pos[hh] = (u32)view_chart[vp].pos;
+        }
+        else {
+            indices.added_map.insert({key, view_chart.size()});
+            view_chart.push_back({key, record.pos, r});
+
+            u32 hh = hash32(key.c_str());
+            indices.release_pos.insert({hh, (u32)record.pos});
+        }
+    }
+}
+
+void merge_flat(const SnapshotTables& snapshot, FlatIndices& indices, std::vector<ChartItem>& view_chart)
+{
+    for(u32 r = 0; r < snapshot.header->record_count; ++r)
+    {
+        const SnapshotRecord& record = snapshot.records[r];
+        u64 hh = hash64(snapshot.str(record.key), record.key.length);
+
+        size_t* added = indices.added_map.find(hh);
+        if(added) {
+            auto vp = *added;
+            view_chart[vp].pos = std::min<u32>((u32)record.pos, (u32)view_chart[vp].pos);
+            indices.release_pos[hh] = (u32)view_chart[vp].pos;
+        }
+        else {
+            indices.added_map.insert(hh, view_chart.size());
+            view_chart.push_back({snapshot.str(record.key), record.pos, r});
+            indices.release_pos.insert(hh, (u32)record.pos);
+        }
+    }
+}
+
+// returns the folders the sweep would delete
+size_t sweep_map(const std::vector<std::string>& folders, std::map<u32, u32>& release_pos, u32 cache_range)
+{
+    size_t removed = 0;
+    for(auto& bn : folders)
+    {
+        bool remove = true;
+        u32 bnh = hash32(bn.c_str());
+        if(release_pos.find(bnh) != release_pos.end()) {
+            remove = release_pos[bnh] > cache_range;
+        }
+        removed += remove ? 1 : 0;
+    }
+    return removed;
+}
+
+size_t sweep_flat(const std::vector<std::string>& folders, FlatHashMap<u32>& release_pos, u32 cache_range)
+{
+    size_t removed = 0;
+    for(auto& bn : folders)
+    {
+        bool remove = true;
+        u32* pos = release_pos.find(hash64(bn.c_str(), bn.length()));
+        if(pos) {
+            remove = *pos > cache_range;
+        }
+        removed += remove ? 1 : 0;
+    }
+    return removed;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    std::string base = argc > 1 ? argv[1] : "http://localhost:8091";
+    std::string store = argc > 2 ? argv[2] : "juno";
+    std::string view = argc > 3 ? argv[3] : "new_releases";
+    size_t folder_count = argc > 4 ? (size_t)atoi(argv[4]) : 20000;
+    const int iterations = 20;
+    const u32 cache_range = 500;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    std::string stores_body;
+    fetch(base + "/stores.json", stores_body);
+
+    std::vector<std::string> sections;
+    try {
+        auto stores = nlohmann::json::parse(stores_body);
+        for(auto& section : stores[store]["sections"]) {
+            sections.push_back(section.get<std::string>());
+        }
+    }
+    catch(...) {
+        fprintf(stderr, "failed to read the sections of %s from %s\n", store.c_str(), base.c_str());
+        return 1;
+    }
+
+    // one snapshot per section index, as the loader holds them
+    std::deque<std::vector<u8>> buffers;
+    std::vector<SnapshotTables> snapshots;
+    size_t records = 0;
+    for(auto& section : sections)
+    {
+        std::string index_on = store + "-" + section + "-" + view;
+        std::string body;
+        buffers.emplace_back();
+        if(!fetch(base + "/releases.json?orderBy=%22" + index_on + "%22&startAt=0", body)
+            || !read_registry_snapshot(body.data(), body.size(), index_on.c_str(), buffers.back())) {
+            fprintf(stderr, "failed to fetch %s\n", index_on.c_str());
+            return 1;
+        }
+
+        snapshots.emplace_back();
+        fixup_registry_snapshot(snapshots.back(), buffers.back().data(), buffers.back().size());
+        records += snapshots.back().header->record_count;
+    }
+    curl_global_cleanup();
+
+    // merge
+    double map_merge_ms = 0.0;
+    double flat_merge_ms = 0.0;
+    size_t view_size = 0;
+    MapIndices map_indices;
+    FlatIndices flat_indices;
+    for(int i = 0; i < iterations; ++i)
+    {
+        std::vector<ChartItem> map_chart;
+        map_indices = {};
+        auto start = std::chrono::steady_clock::now();
+        for(auto& snapshot : snapshots) {
+            merge_map(snapshot, map_indices, map_chart);
+        }
+        map_merge_ms += elapsed_ms(start);
+
+        std::vector<ChartItem> flat_chart;
+        flat_indices = {};
+        start = std::chrono::steady_clock::now();
+        for(auto& snapshot : snapshots) {
+            merge_flat(snapshot, flat_indices, flat_chart);
+        }
+        flat_merge_ms += elapsed_ms(start);
+
+        if(map_chart.size() != flat_chart.size()) {
+            fprintf(stderr, "chart mismatch: map %zu flat %zu\n", map_chart.size(), flat_chart.size());
+            return 1;
+        }
+        view_size = flat_chart.size();
+    }
+
+    // cache folders named by release key, those in the view and releases which have dropped out of it
+    std::vector<std::string> folders;
+    for(auto& item : map_indices.added_map) {
+        if(folders.size() < folder_count) {
+            folders.push_back(item.first);
+        }
+    }
+    for(size_t i = 0; folders.size() < folder_count; ++i) {
+        folders.push_back(store + "-gone" + std::to_string(i));
+    }
+
+    double map_sweep_ms = 0.0;
+    double flat_sweep_ms = 0.0;
+    size_t removed = 0;
+    for(int i = 0; i < iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        size_t map_removed = sweep_map(folders, map_indices.release_pos, cache_range);
+        map_sweep_ms += elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        removed = sweep_flat(folders, flat_indices.release_pos, cache_range);
+        flat_sweep_ms += elapsed_ms(start);
+
+        if(map_removed != removed) {
+            fprintf(stderr, "sweep mismatch: map %zu flat %zu\n", map_removed, removed);
+            return 1;
+        }
+    }
+
+    printf("%s %s: %zu sections, %zu records, %zu releases in the view, %zu folders swept (%zu removed)\n",
+        store.c_str(), view.c_str(), sections.size(), records, view_size, folders.size(), removed);
+    printf("%-8s %14s %14s\n", "index", "merge ms", "sweep ms");
+    printf("%-8s %14.3f %14.3f\n", "std::map", map_merge_ms / iterations, map_sweep_ms / iterations);
+    printf("%-8s %14.3f %14.3f\n", "flat", flat_merge_ms / iterations, flat_sweep_ms / iterations);
+    printf("speedup  %13.1fx %13.1fx\n", map_merge_ms / flat_merge_ms, map_sweep_ms / flat_sweep_ms);
+    return 0;
+}
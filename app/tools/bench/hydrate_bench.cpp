@@ -0,0 +1,202 @@
+// likes refresh time against like count, serial per key queries (the old update_likes_registry) vs the
+// batch hydrate_releases does now: the same per key queries added to one multi handle, multiplexed on
+// http/2 or spread over k_max_concurrent_transfers connections on http/1.1, at most k_max_batch_streams
+// in flight. both parse each response into the registry like the app.
+// build:
+//   g++ -O2 -std=c++17 -I../../code hydrate_bench.cpp -lcurl -o hydrate_bench
+// run against a stand-in with enough releases and its default database latency as the round trip:
+//   python3 ../firebase_standin.py -port 8091 -releases 1000 -latency 0.05
+//   ./hydrate_bench http://localhost:8091 25 50 100 200 500
+#include <curl/curl.h>
+#include "json.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+constexpr long k_max_concurrent_transfers = 6;
+constexpr size_t k_max_batch_streams = 32;
+
+size_t append(void* ptr, size_t size, size_t nmemb, std::string* body)
+{
+    body->append((const char*)ptr, size * nmemb);
+    return size * nmemb;
+}
+
+void setup(CURL* curl, const std::string& url, std::string* body)
+{
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, append);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, body);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+}
+
+std::string key_url(const std::string& base, const std::string& key)
+{
+    return base + "/releases.json?orderBy=%22$key%22&equalTo=%22" + key + "%22&timeout=1s";
+}
+
+size_t store(const std::string& key, const std::string& body, nlohmann::json& registry)
+{
+    try {
+        auto release = nlohmann::json::parse(body);
+        if(release.contains(key) && !release[key].is_null()) {
+            registry[key] = std::move(release[key]);
+            return 1;
+        }
+    }
+    catch(...) {
+        //
+    }
+    return 0;
+}
+
+size_t hydrate_serial(const std::string& base, const std::vector<std::string>& keys, nlohmann::json& registry)
+{
+    size_t found = 0;
+    CURL* curl = curl_easy_init();
+    for(auto& key : keys)
+    {
+        std::string body;
+        curl_easy_reset(curl);
+        setup(curl, key_url(base, key), &body);
+        if(curl_easy_perform(curl) == CURLE_OK) {
+            found += store(key, body, registry);
+        }
+    }
+    curl_easy_cleanup(curl);
+    return found;
+}
+
+size_t hydrate_batch(const std::string& base, const std::vector<std::string>& keys, nlohmann::json& registry)
+{
+    std::vector<std::string> bodies(keys.size());
+    std::vector<CURL*> pool;
+
+    CURLM* multi = curl_multi_init();
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, k_max_concurrent_transfers);
+
+    size_t found = 0;
+    size_t next = 0;
+    size_t in_flight = 0;
+    int running = 1;
+    while(next < keys.size() || in_flight > 0)
+    {
+        while(next < keys.size() && in_flight < k_max_batch_streams)
+        {
+            CURL* curl = nullptr;
+            if(!pool.empty()) {
+                curl = pool.back();
+                pool.pop_back();
+            }
+            else {
+                curl = curl_easy_init();
+            }
+
+            setup(curl, key_url(base, keys[next]), &bodies[next]);
+            curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+            curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)next);
+            curl_multi_add_handle(multi, curl);
+            in_flight++;
+            next++;
+        }
+
+        curl_multi_perform(multi, &running);
+
+        int msgs = 0;
+        while(CURLMsg* msg = curl_multi_info_read(multi, &msgs))
+        {
+            if(msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            CURL* curl = msg->easy_handle;
+            void* index = nullptr;
+            curl_easy_getinfo(curl, CURLINFO_PRIVATE, &index);
+            if(msg->data.result == CURLE_OK) {
+                found += store(keys[(size_t)index], bodies[(size_t)index], registry);
+            }
+
+            curl_multi_remove_handle(multi, curl);
+            curl_easy_reset(curl);
+            pool.push_back(curl);
+            in_flight--;
+        }
+
+        if(running > 0) {
+            curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+        }
+    }
+
+    for(auto* curl : pool) {
+        curl_easy_cleanup(curl);
+    }
+    curl_multi_cleanup(multi);
+    return found;
+}
+
+int main(int argc, char** argv)
+{
+    std::string base = argc > 1 ? argv[1] : "http://localhost:8091";
+    std::vector<size_t> counts;
+    for(int i = 2; i < argc; ++i) {
+        counts.push_back((size_t)atoi(argv[i]));
+    }
+    if(counts.empty()) {
+        counts = {25, 50, 100, 200, 500};
+    }
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    // the liked keys, the first releases of the registry
+    size_t max_count = 0;
+    for(auto c : counts) {
+        max_count = std::max(max_count, c);
+    }
+
+    std::string body;
+    CURL* curl = curl_easy_init();
+    setup(curl, base + "/releases.json?orderBy=%22$key%22&limitToFirst=" + std::to_string(max_count), &body);
+    curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+
+    std::vector<std::string> all_keys;
+    try {
+        for(auto& item : nlohmann::json::parse(body).items()) {
+            all_keys.push_back(item.key());
+        }
+    }
+    catch(...) {
+        fprintf(stderr, "failed to list releases from %s\n", base.c_str());
+        return 1;
+    }
+
+    printf("%8s %8s %12s %12s %8s\n", "likes", "found", "serial ms", "batch ms", "speedup");
+    for(auto count : counts)
+    {
+        std::vector<std::string> keys(all_keys.begin(), all_keys.begin() + std::min(count, all_keys.size()));
+
+        nlohmann::json serial_registry = nlohmann::json::object();
+        auto start = std::chrono::steady_clock::now();
+        size_t serial_found = hydrate_serial(base, keys, serial_registry);
+        double serial_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        nlohmann::json batch_registry = nlohmann::json::object();
+        start = std::chrono::steady_clock::now();
+        size_t batch_found = hydrate_batch(base, keys, batch_registry);
+        double batch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if(serial_found != batch_found) {
+            fprintf(stderr, "found mismatch: serial %zu batch %zu\n", serial_found, batch_found);
+        }
+
+        printf("%8zu %8zu %12.1f %12.1f %7.1fx\n", keys.size(), batch_found, serial_ms, batch_ms, serial_ms / batch_ms);
+    }
+
+    curl_global_cleanup();
+    return 0;
+}
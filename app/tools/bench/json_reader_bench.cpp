@@ -0,0 +1,160 @@
+// registry page to snapshot, nlohmann::json::parse into a dict then build_registry_snapshot (the loaders
+// before the on demand reader) vs read_registry_snapshot straight off the downloaded bytes. the body is
+// fetched once from the stand-in, either the whole registry or an index query with its chart position,
+// and both paths must produce the same records. the string scan is sse2 by default on x86_64, build with
+// -mavx2 for the avx2 path.
+// build:
+//   g++ -O2 -std=c++17 -I../../code -I../../pmtech/core/pen/include json_reader_bench.cpp -lcurl -o json_reader_bench
+// run against a stand-in with a multi mb registry:
+//   python3 ../firebase_standin.py -port 8091 -releases 20000 -latency 0
+//   ./json_reader_bench http://localhost:8091 20
+//   ./json_reader_bench http://localhost:8091 20 juno-techno-music-new_releases
+#include <curl/curl.h>
+#include "registry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+size_t append(void* ptr, size_t size, size_t nmemb, std::string* body)
+{
+    body->append((const char*)ptr, size * nmemb);
+    return size * nmemb;
+}
+
+bool fetch(const std::string& url, std::string& body)
+{
+    CURL* curl = curl_easy_init();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, append);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    return res == CURLE_OK;
+}
+
+// the string tables are laid out in the order each path meets the strings, so compare what the records
+// resolve to rather than the bytes
+bool same_snapshot(const std::vector<u8>& a_data, const std::vector<u8>& b_data)
+{
+    SnapshotTables a, b;
+    if(!fixup_registry_snapshot(a, a_data.data(), a_data.size()) || !fixup_registry_snapshot(b, b_data.data(), b_data.size())) {
+        return false;
+    }
+
+    if(a.header->record_count != b.header->record_count || a.header->ref_count != b.header->ref_count) {
+        return false;
+    }
+
+    auto same = [&](const SnapshotString& sa, const SnapshotString& sb) {
+        return sa.length == sb.length && strcmp(a.str(sa), b.str(sb)) == 0;
+    };
+
+    auto same_refs = [&](u32 a_first, u32 b_first, u32 count) {
+        for(u32 i = 0; i < count; ++i) {
+            if(!same(a.refs[a_first + i], b.refs[b_first + i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for(u32 r = 0; r < a.header->record_count; ++r)
+    {
+        const SnapshotRecord& ra = a.records[r];
+        const SnapshotRecord& rb = b.records[r];
+        if(!same(ra.key, rb.key) || !same(ra.id, rb.id) || !same(ra.artist, rb.artist) || !same(ra.title, rb.title)
+            || !same(ra.link, rb.link) || !same(ra.label, rb.label) || !same(ra.cat, rb.cat) || !same(ra.store, rb.store)
+            || !same(ra.label_link, rb.label_link) || !same(ra.discogs_url, rb.discogs_url)
+            || !same(ra.resource_url, rb.resource_url)) {
+            return false;
+        }
+
+        if(ra.discogs_id != rb.discogs_id || ra.pos != rb.pos || ra.like_count != rb.like_count
+            || ra.store_tags != rb.store_tags || ra.artworks_count != rb.artworks_count
+            || ra.track_names_count != rb.track_names_count || ra.track_urls_count != rb.track_urls_count) {
+            return false;
+        }
+
+        if(!same_refs(ra.artworks_first, rb.artworks_first, ra.artworks_count)
+            || !same_refs(ra.track_names_first, rb.track_names_first, ra.track_names_count)
+            || !same_refs(ra.track_urls_first, rb.track_urls_first, ra.track_urls_count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename F>
+double time_ms(int iterations, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; ++i) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    std::string base = argc > 1 ? argv[1] : "http://localhost:8091";
+    int iterations = argc > 2 ? atoi(argv[2]) : 20;
+    const c8* index_on = argc > 3 ? argv[3] : nullptr;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    std::string url = base + "/releases.json";
+    if(index_on) {
+        url += "?orderBy=%22" + std::string(index_on) + "%22&startAt=0";
+    }
+
+    std::string body;
+    if(!fetch(url, body)) {
+        fprintf(stderr, "failed to fetch %s\n", url.c_str());
+        return 1;
+    }
+    curl_global_cleanup();
+
+    std::vector<u8> dict_snap;
+    std::vector<u8> reader_snap;
+
+    double dict_ms = time_ms(iterations, [&]() {
+        dict_snap.clear();
+        build_registry_snapshot(nlohmann::json::parse(body), index_on, dict_snap);
+    });
+
+    bool ok = true;
+    double reader_ms = time_ms(iterations, [&]() {
+        reader_snap.clear();
+        ok &= read_registry_snapshot(body.data(), body.size(), index_on, reader_snap);
+    });
+
+    if(!ok || !same_snapshot(dict_snap, reader_snap)) {
+        fprintf(stderr, "snapshots differ: dict %zu bytes, reader %zu bytes\n", dict_snap.size(), reader_snap.size());
+        return 1;
+    }
+
+#if defined(JSON_SCAN_AVX2)
+    const c8* scan = "avx2";
+#elif defined(JSON_SCAN_SSE2)
+    const c8* scan = "sse2";
+#elif defined(JSON_SCAN_NEON)
+    const c8* scan = "neon";
+#else
+    const c8* scan = "scalar";
+#endif
+
+    SnapshotTables snapshot;
+    fixup_registry_snapshot(snapshot, reader_snap.data(), reader_snap.size());
+
+    f64 mb = body.size() / (1024.0 * 1024.0);
+    printf("%s, %u releases, body %.2fMB, scan %s\n", index_on ? index_on : "registry", snapshot.header->record_count, mb, scan);
+    printf("%-10s %12s %12s\n", "path", "ms", "MB/s");
+    printf("%-10s %12.2f %12.1f\n", "nlohmann", dict_ms, mb / (dict_ms / 1000.0));
+    printf("%-10s %12.2f %12.1f\n", "reader", reader_ms, mb / (reader_ms / 1000.0));
+    printf("speedup %.1fx\n", dict_ms / reader_ms);
+    return 0;
+}
@@ -0,0 +1,351 @@
+// replays the request pattern of a feed view load against the stand-in and reports time to first entry and
+// time to all artwork. releases_view_loader's side: the first page of every section index fetched on its
+// own thread, read into a snapshot and merged, then further pages until the view holds the requested
+// number of releases. data_cache_fetch's side: the artwork of each of those releases through one multi
+// handle with at most k_max_concurrent_transfers in flight, as the curl engine runs them. serial is the
+// pattern from before the engine for a baseline: sections one after another and one artwork at a time.
+// artwork bodies are counted and dropped rather than written to the cache.
+// build:
+//   g++ -O2 -std=c++17 -I../../code -I../../pmtech/core/pen/include loader_bench.cpp -lcurl -lpthread -o loader_bench
+// run against a stand-in with a 500+ release view and its default database and cdn latencies:
+//   python3 ../firebase_standin.py -port 8091 -releases 3000
+//   ./loader_bench http://localhost:8091 juno new_releases 500
+#include <curl/curl.h>
+#include "registry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+constexpr u32 k_feed_page_size = 100;
+constexpr long k_max_concurrent_transfers = 6;
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+size_t append(void* ptr, size_t size, size_t nmemb, std::string* body)
+{
+    body->append((const char*)ptr, size * nmemb);
+    return size * nmemb;
+}
+
+size_t count_bytes(void* ptr, size_t size, size_t nmemb, size_t* bytes)
+{
+    *bytes += size * nmemb;
+    return size * nmemb;
+}
+
+bool fetch(CURL* curl, const std::string& url, std::string& body)
+{
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, append);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    return curl_easy_perform(curl) == CURLE_OK;
+}
+
+double ms_since(TimePoint start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Section
+{
+    std::string index_on;
+    f64         last_pos = 0.0;
+    u32         page = 0;
+    bool        exhausted = false;
+};
+
+struct ViewLoad
+{
+    std::string                 base;
+    std::vector<Section>        sections;
+    std::deque<std::vector<u8>> snapshots;
+    std::vector<std::string>    artwork_urls;
+    FlatHashMap<size_t>         added_map;
+    std::mutex                  merge_mutex;
+    size_t                      art_index = 0;
+    size_t                      requests = 0;
+    size_t                      registry_bytes = 0;
+};
+
+// one page of a section, the same query and merge as releases_view_loader's fetch_page
+bool fetch_page(ViewLoad& load, Section& section, CURL* curl)
+{
+    c8 query[256];
+    snprintf(query, sizeof(query), "/releases.json?orderBy=%%22%s%%22&startAt=%u&limitToFirst=%u&timeout=10s",
+        section.index_on.c_str(), (u32)section.last_pos, k_feed_page_size);
+
+    std::string body;
+    std::vector<u8> buffer;
+    if(!fetch(curl, load.base + query, body) || !read_registry_snapshot(body.data(), body.size(), section.index_on.c_str(), buffer)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(load.merge_mutex);
+    load.requests++;
+    load.registry_bytes += body.size();
+    load.snapshots.push_back(std::move(buffer));
+
+    SnapshotTables snapshot;
+    fixup_registry_snapshot(snapshot, load.snapshots.back().data(), load.snapshots.back().size());
+
+    f64 prev_last_pos = section.last_pos;
+    u32 record_count = snapshot.header->record_count;
+    for(u32 r = 0; r < record_count; ++r)
+    {
+        const SnapshotRecord& record = snapshot.records[r];
+        u64 hh = hash64(snapshot.str(record.key), record.key.length);
+        if(load.added_map.insert(hh, load.artwork_urls.size())) {
+            const SnapshotString* artworks = snapshot.refs + record.artworks_first;
+            size_t art_index = load.art_index < record.artworks_count ? load.art_index : 0;
+            load.artwork_urls.push_back(record.artworks_count > 0 ? snapshot.str(artworks[art_index]) : "");
+        }
+    }
+
+    if(record_count > 0) {
+        section.last_pos = std::max<f64>(section.last_pos, snapshot.records[record_count - 1].pos);
+    }
+
+    if(record_count < k_feed_page_size || (section.page > 0 && section.last_pos <= prev_last_pos)) {
+        section.exhausted = true;
+    }
+    section.page++;
+    return true;
+}
+
+// pages sections round robin, as scrolling towards the end of the view does, until it holds enough releases
+void fetch_remaining_pages(ViewLoad& load, size_t release_count, CURL* curl)
+{
+    for(;;)
+    {
+        bool more = false;
+        for(auto& section : load.sections)
+        {
+            if(load.artwork_urls.size() >= release_count) {
+                return;
+            }
+
+            if(!section.exhausted) {
+                more = true;
+                if(!fetch_page(load, section, curl)) {
+                    section.exhausted = true;
+                }
+            }
+        }
+
+        if(!more) {
+            return;
+        }
+    }
+}
+
+size_t fetch_artwork_serial(const std::vector<std::string>& urls, size_t& bytes)
+{
+    size_t fetched = 0;
+    CURL* curl = curl_easy_init();
+    for(auto& url : urls)
+    {
+        curl_easy_reset(curl);
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, count_bytes);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &bytes);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        if(curl_easy_perform(curl) == CURLE_OK) {
+            fetched++;
+        }
+    }
+    curl_easy_cleanup(curl);
+    return fetched;
+}
+
+// the curl engine's loop: up to k_max_concurrent_transfers active on one multi, refilled as they complete
+size_t fetch_artwork_engine(const std::vector<std::string>& urls, size_t& bytes)
+{
+    CURLM* multi = curl_multi_init();
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, k_max_concurrent_transfers);
+
+    std::vector<CURL*> pool;
+    size_t fetched = 0;
+    size_t next = 0;
+    size_t active = 0;
+    while(next < urls.size() || active > 0)
+    {
+        while(next < urls.size() && active < (size_t)k_max_concurrent_transfers)
+        {
+            CURL* curl = nullptr;
+            if(!pool.empty()) {
+                curl = pool.back();
+                pool.pop_back();
+            }
+            else {
+                curl = curl_easy_init();
+            }
+
+            curl_easy_setopt(curl, CURLOPT_URL, urls[next].c_str());
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, count_bytes);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &bytes);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+            curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+            curl_multi_add_handle(multi, curl);
+            active++;
+            next++;
+        }
+
+        s32 running = 0;
+        curl_multi_perform(multi, &running);
+
+        s32 msgs = 0;
+        while(CURLMsg* msg = curl_multi_info_read(multi, &msgs))
+        {
+            if(msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            if(msg->data.result == CURLE_OK) {
+                fetched++;
+            }
+
+            CURL* curl = msg->easy_handle;
+            curl_multi_remove_handle(multi, curl);
+            curl_easy_reset(curl);
+            pool.push_back(curl);
+            active--;
+        }
+
+        if(running > 0) {
+            curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+        }
+    }
+
+    for(auto* curl : pool) {
+        curl_easy_cleanup(curl);
+    }
+    curl_multi_cleanup(multi);
+    return fetched;
+}
+
+void load_view(const std::string& base, const std::string& store, const std::string& view, size_t release_count,
+    const nlohmann::json& stores, bool serial)
+{
+    ViewLoad load;
+    load.base = base;
+
+    auto& info = stores[store];
+    if(info.contains("art_index")) {
+        load.art_index = info["art_index"].get<size_t>();
+    }
+
+    for(auto& section : info["sections"]) {
+        Section s;
+        s.index_on = store + "-" + section.get<std::string>() + "-" + view;
+        load.sections.push_back(s);
+    }
+
+    TimePoint start = std::chrono::steady_clock::now();
+
+    // first pages, in parallel or one after another
+    if(serial) {
+        CURL* curl = curl_easy_init();
+        for(auto& section : load.sections) {
+            if(!fetch_page(load, section, curl)) {
+                section.exhausted = true;
+            }
+        }
+        curl_easy_cleanup(curl);
+    }
+    else {
+        std::vector<std::thread> fetches;
+        for(auto& section : load.sections) {
+            Section* s = &section;
+            fetches.push_back(std::thread([&load, s]() {
+                CURL* curl = curl_easy_init();
+                if(!fetch_page(load, *s, curl)) {
+                    s->exhausted = true;
+                }
+                curl_easy_cleanup(curl);
+            }));
+        }
+
+        for(auto& fetch : fetches) {
+            fetch.join();
+        }
+    }
+
+    // the loader publishes once the first pages are merged
+    double first_entry_ms = ms_since(start);
+
+    CURL* curl = curl_easy_init();
+    fetch_remaining_pages(load, release_count, curl);
+    curl_easy_cleanup(curl);
+
+    double all_entries_ms = ms_since(start);
+
+    std::vector<std::string> urls;
+    for(size_t i = 0; i < load.artwork_urls.size() && urls.size() < release_count; ++i) {
+        if(!load.artwork_urls[i].empty()) {
+            urls.push_back(load.artwork_urls[i]);
+        }
+    }
+
+    size_t artwork_bytes = 0;
+    size_t artwork_fetched = serial ? fetch_artwork_serial(urls, artwork_bytes) : fetch_artwork_engine(urls, artwork_bytes);
+    double all_artwork_ms = ms_since(start);
+
+    printf("%-8s %8zu %8zu %10zu %12.1f %12.1f %12.1f %10.2f\n",
+        serial ? "serial" : "engine", std::min(load.artwork_urls.size(), release_count), load.requests, artwork_fetched,
+        first_entry_ms, all_entries_ms, all_artwork_ms, (load.registry_bytes + artwork_bytes) / (1024.0 * 1024.0));
+}
+
+int main(int argc, char** argv)
+{
+    std::string base = argc > 1 ? argv[1] : "http://localhost:8091";
+    std::string store = argc > 2 ? argv[2] : "juno";
+    std::string view = argc > 3 ? argv[3] : "new_releases";
+    size_t release_count = argc > 4 ? (size_t)atoi(argv[4]) : 500;
+    int runs = argc > 5 ? atoi(argv[5]) : 3;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    // stores are loaded before any view, outside the timings
+    nlohmann::json stores;
+    std::string stores_body;
+    CURL* curl = curl_easy_init();
+    bool fetched = fetch(curl, base + "/stores.json", stores_body);
+    curl_easy_cleanup(curl);
+
+    try {
+        stores = nlohmann::json::parse(stores_body);
+    }
+    catch(...) {
+        fetched = false;
+    }
+
+    if(!fetched || !stores.contains(store)) {
+        fprintf(stderr, "failed to load store %s from %s\n", store.c_str(), base.c_str());
+        return 1;
+    }
+
+    printf("%s %s\n", store.c_str(), view.c_str());
+    printf("%-8s %8s %8s %10s %12s %12s %12s %10s\n",
+        "pattern", "releases", "pages", "artworks", "first ms", "entries ms", "artwork ms", "MB");
+    for(int r = 0; r < runs; ++r) {
+        load_view(base, store, view, release_count, stores, false);
+    }
+
+    for(int r = 0; r < runs; ++r) {
+        load_view(base, store, view, release_count, stores, true);
+    }
+
+    curl_global_cleanup();
+    return 0;
+}
@@ -0,0 +1,181 @@
+// cached registry load, the json cache file parsed into a dict (what the loaders did before snapshots) vs
+// the binary snapshot mapped and fixed up in place. both walk every release reading a couple of fields so
+// the dict lookups and the snapshot pages are paid for. the registry is fetched once from the stand-in and
+// written to both files the way the app caches it, the one off cost of building the snapshot on download
+// is reported too.
+// build:
+//   g++ -O2 -std=c++17 -I../../code -I../../pmtech/core/pen/include snapshot_bench.cpp -lcurl -o snapshot_bench
+// run against a stand-in with a registry of the size to measure:
+//   python3 ../firebase_standin.py -port 8091 -releases 5000 -latency 0
+//   ./snapshot_bench http://localhost:8091 50
+#include <curl/curl.h>
+#include "registry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+size_t append(void* ptr, size_t size, size_t nmemb, std::string* body)
+{
+    body->append((const char*)ptr, size * nmemb);
+    return size * nmemb;
+}
+
+bool fetch(const std::string& url, std::string& body)
+{
+    CURL* curl = curl_easy_init();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, append);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &body);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    return res == CURLE_OK;
+}
+
+bool write_file(const char* filepath, const void* data, size_t size)
+{
+    FILE* fp = fopen(filepath, "wb");
+    if(!fp) {
+        return false;
+    }
+    fwrite(data, size, 1, fp);
+    fclose(fp);
+    return true;
+}
+
+std::string read_file(const char* filepath)
+{
+    std::string data;
+    FILE* fp = fopen(filepath, "rb");
+    if(fp) {
+        fseek(fp, 0, SEEK_END);
+        data.resize(ftell(fp));
+        fseek(fp, 0, SEEK_SET);
+        fread(&data[0], data.size(), 1, fp);
+        fclose(fp);
+    }
+    return data;
+}
+
+// the old cached load, returns a checksum of the fields read
+size_t load_json(const char* filepath, size_t& releases)
+{
+    std::string data = read_file(filepath);
+    nlohmann::json dict = nlohmann::json::parse(data);
+
+    size_t sum = 0;
+    releases = 0;
+    for(auto& item : dict.items())
+    {
+        auto& release = item.value();
+        auto artist = release.find("artist");
+        if(artist != release.end() && artist->is_string()) {
+            auto& str = artist->get_ref<const std::string&>();
+            sum += str.length() + (u8)str[0];
+        }
+
+        auto artworks = release.find("artworks");
+        if(artworks != release.end() && artworks->is_array()) {
+            sum += artworks->size();
+        }
+        releases++;
+    }
+    return sum;
+}
+
+// the snapshot load, map_registry_snapshot and the same walk over the records
+size_t load_snapshot(const char* filepath, size_t& releases)
+{
+    int fd = open(filepath, O_RDONLY);
+    struct stat st;
+    fstat(fd, &st);
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    SnapshotTables snapshot;
+    size_t sum = 0;
+    releases = 0;
+    if(fixup_registry_snapshot(snapshot, (const u8*)mapped, (size_t)st.st_size))
+    {
+        for(u32 r = 0; r < snapshot.header->record_count; ++r)
+        {
+            const SnapshotRecord& record = snapshot.records[r];
+            sum += record.artist.length + (u8)snapshot.str(record.artist)[0];
+            sum += record.artworks_count;
+            releases++;
+        }
+    }
+
+    munmap(mapped, (size_t)st.st_size);
+    return sum;
+}
+
+template<typename F>
+double time_ms(int iterations, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; ++i) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    std::string base = argc > 1 ? argv[1] : "http://localhost:8091";
+    int iterations = argc > 2 ? atoi(argv[2]) : 50;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    std::string body;
+    if(!fetch(base + "/releases.json", body)) {
+        fprintf(stderr, "failed to fetch the registry from %s\n", base.c_str());
+        return 1;
+    }
+    curl_global_cleanup();
+
+    const char* json_path = "snapshot_bench.json";
+    const char* snap_path = "snapshot_bench.snap";
+
+    std::vector<u8> snap;
+    double build_ms = time_ms(5, [&]() {
+        snap.clear();
+        build_registry_snapshot(nlohmann::json::parse(body), nullptr, snap);
+    });
+
+    write_file(json_path, body.data(), body.size());
+    write_file(snap_path, snap.data(), snap.size());
+
+    size_t json_releases = 0, snap_releases = 0;
+    size_t json_sum = 0, snap_sum = 0;
+
+    // warm the page cache for both before timing
+    load_json(json_path, json_releases);
+    load_snapshot(snap_path, snap_releases);
+
+    double json_ms = time_ms(iterations, [&]() { json_sum = load_json(json_path, json_releases); });
+    double snap_ms = time_ms(iterations, [&]() { snap_sum = load_snapshot(snap_path, snap_releases); });
+
+    if(json_sum != snap_sum || json_releases != snap_releases) {
+        fprintf(stderr, "mismatch: json %zu releases sum %zu, snapshot %zu releases sum %zu\n",
+            json_releases, json_sum, snap_releases, snap_sum);
+    }
+
+    printf("releases %zu, json %.2fMB, snapshot %.2fMB, snapshot build %.2fms (once per download)\n",
+        json_releases, body.size() / (1024.0 * 1024.0), snap.size() / (1024.0 * 1024.0), build_ms);
+    printf("%-10s %12s\n", "load", "ms");
+    printf("%-10s %12.3f\n", "json", json_ms);
+    printf("%-10s %12.3f\n", "snapshot", snap_ms);
+    printf("speedup %.1fx\n", json_ms / snap_ms);
+
+    remove(json_path);
+    remove(snap_path);
+    return 0;
+}
@@ -0,0 +1,151 @@
+# local stand-in for the discogs api, enforcing the same per-token moving window rate limit and
+# X-Discogs-Ratelimit headers as the real service so client throughput can be measured offline.
+# run: python3 discogs_standin.py -port 8090 -limit 60
+# then launch the app with DIIG_DISCOGS_API=http://localhost:8090
+import json
+import sys
+import time
+import threading
+import collections
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlparse
+
+
+# defaults, overridden from the command line
+config = {
+    "port": 8090,
+    "limit": 60,        # requests per token per 60s window
+    "latency": 0.15,    # seconds added to each response
+    "results": 50,      # releases returned from a search
+    "videos": 4         # videos per release detail
+}
+
+lock = threading.Lock()
+windows = collections.defaultdict(collections.deque)
+stats = {
+    "ok": 0,
+    "limited": 0,
+    "start": time.time()
+}
+
+
+def parse_args():
+    i = 1
+    while i < len(sys.argv):
+        key = sys.argv[i].lstrip("-")
+        if key in config and i + 1 < len(sys.argv):
+            config[key] = type(config[key])(sys.argv[i + 1])
+            i += 1
+        i += 1
+
+
+# returns (allowed, used, remaining) for the token, in a moving 60s window
+def take(token):
+    now = time.time()
+    with lock:
+        window = windows[token]
+        while len(window) > 0 and now - window[0] > 60.0:
+            window.popleft()
+        allowed = len(window) < config["limit"]
+        if allowed:
+            window.append(now)
+            stats["ok"] += 1
+        else:
+            stats["limited"] += 1
+        used = len(window)
+        return allowed, used, max(config["limit"] - used, 0)
+
+
+def release_summary(base, rid):
+    return {
+        "id": rid,
+        "type": "release",
+        "master_id": 0,
+        "title": f"Standin Artist {rid} - Standin Title {rid}",
+        "catno": f"SI{rid:04d}",
+        "year": str(1990 + rid % 30),
+        "label": [f"Standin Label {rid % 7}"],
+        "uri": f"/release/{rid}",
+        "resource_url": f"{base}/releases/{rid}",
+        "cover_image": ""
+    }
+
+
+def release_detail(rid):
+    return {
+        "id": rid,
+        "videos": [
+            {
+                "uri": f"https://www.youtube.com/watch?v=si{rid:05d}{v:04d}",
+                "title": f"Standin Track {v + 1}"
+            }
+            for v in range(config["videos"])
+        ]
+    }
+
+
+class Handler(BaseHTTPRequestHandler):
+    def log_message(self, format, *args):
+        pass
+
+    def respond(self, code, body, used, remaining):
+        data = json.dumps(body).encode("utf-8")
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.send_header("X-Discogs-Ratelimit", str(config["limit"]))
+        self.send_header("X-Discogs-Ratelimit-Used", str(used))
+        self.send_header("X-Discogs-Ratelimit-Remaining", str(remaining))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def handle_request(self):
+        time.sleep(config["latency"])
+        token = self.headers.get("Authorization", "anonymous")
+        allowed, used, remaining = take(token)
+        if not allowed:
+            self.respond(429, {"message": "You are making requests too quickly."}, used, remaining)
+            return
+
+        path = urlparse(self.path).path
+        base = f"http://{self.headers.get('Host')}"
+        if path == "/database/search":
+            results = [release_summary(base, rid) for rid in range(1, config["results"] + 1)]
+            self.respond(200, {"pagination": {"page": 1, "pages": 1}, "results": results}, used, remaining)
+        elif path.startswith("/releases/"):
+            rid = int(path.split("/")[-1])
+            self.respond(200, release_detail(rid), used, remaining)
+        elif path == "/oauth/identity":
+            self.respond(200, {"id": 1, "username": "standin"}, used, remaining)
+        elif path.startswith("/users/") and "/wants/" in path:
+            self.respond(201, {}, used, remaining)
+        else:
+            self.respond(404, {"message": "The requested resource was not found."}, used, remaining)
+
+    def do_GET(self):
+        self.handle_request()
+
+    def do_PUT(self):
+        self.handle_request()
+
+    def do_POST(self):
+        self.handle_request()
+
+    def do_DELETE(self):
+        self.handle_request()
+
+
+# prints served and rate limited requests per minute
+def report():
+    while True:
+        time.sleep(10.0)
+        with lock:
+            minutes = (time.time() - stats["start"]) / 60.0
+            print(f"ok: {stats['ok']} ({stats['ok'] / minutes:.1f}/min) 429: {stats['limited']}", flush=True)
+
+
+if __name__ == "__main__":
+    parse_args()
+    threading.Thread(target=report, daemon=True).start()
+    print(f"discogs stand-in on :{config['port']} limit {config['limit']}/min", flush=True)
+    ThreadingHTTPServer(("", config["port"]), Handler).serve_forever()
@@ -0,0 +1,489 @@
+# local stand-in for the firebase realtime database, identity toolkit and the store cdns, so the
+# loaders can be exercised and benchmarked repeatably on a machine with no network. the benchmarks that
+# run against it are in bench/, loader_bench replays a feed view load.
+# run: python3 firebase_standin.py -port 8091 -releases 500 -latency 0.05 -bandwidth 2000000
+# then launch the app with:
+#   DIIG_FIREBASE_URL=http://localhost:8091 DIIG_IDENTITY_URL=http://localhost:8091
+# with -cert and -key (pem files) it serves https instead, a self signed pair will do as the app doesn't
+# verify peers:
+#   openssl req -x509 -newkey rsa:2048 -nodes -subj /CN=localhost -keyout standin.key -out standin.crt
+#
+# registry data comes from a fixtures directory (-fixtures):
+#   stores.json                 store config, defaults to scrape/stores.json
+#   releases.json               full releases registry keyed by release id
+#   <store>-<section>-<view>.json recorded query responses, as cached by the app in its persistent dir
+#   cdn/<host>/<path>           recorded artwork and mp3 files
+# anything missing is synthesised: a registry of -releases entries across every store section view,
+# png artwork and silent mp3s. asset urls in the registry are rewritten to /cdn/ on this server
+#
+# delta sync: releases carry an "updated" scrape stamp. with -scrape_interval N, every N seconds a
+# scrape is simulated which re-ranks, adds and drops -churn releases in the indices and stamps them,
+# clients then fetch only those with orderBy="updated"&startAt=<last stamp they saw>. like counts are written
+# with a server time {".sv": "timestamp"} at likes/updated, which clients query the same way
+import collections
+import copy
+import gzip
+import hashlib
+import json
+import os
+import random
+import ssl
+import struct
+import sys
+import threading
+import time
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlparse, parse_qs, unquote
+
+
+# defaults, overridden from the command line
+config = {
+    "port": 8091,
+    "fixtures": os.path.join(os.path.dirname(os.path.abspath(__file__)), "fixtures"),
+    "releases": 500,        # synthesised releases when there are no fixtures
+    "tracks": 3,            # synthesised tracks per release
+    "latency": 0.05,        # seconds added to each database / auth response
+    "cdn_latency": 0.1,     # seconds added to each cdn response
+    "bandwidth": 0,         # bytes per second per connection, 0 is unlimited
+    "error_rate": 0.0,      # probability of a 500 response
+    "drop_rate": 0.0,       # probability of closing the connection half way through a body
+    "scrape_interval": 0.0, # seconds between simulated scrapes, 0 is off
+    "churn": 20,            # releases changed per simulated scrape
+    "seed": 0,
+    "cert": "",             # pem certificate, serves https when set with -key
+    "key": ""
+}
+
+lock = threading.Lock()
+database = {}
+stats = collections.Counter()
+
+
+def parse_args():
+    i = 1
+    while i < len(sys.argv):
+        key = sys.argv[i].lstrip("-")
+        if key in config and i + 1 < len(sys.argv):
+            config[key] = type(config[key])(sys.argv[i + 1])
+            i += 1
+        i += 1
+
+
+def load_json(filepath):
+    if os.path.exists(filepath):
+        with open(filepath) as f:
+            return json.load(f)
+    return None
+
+
+# rewrites absolute asset urls to be served from /cdn/ on this server, {cdn} is substituted per request
+def to_cdn(url):
+    if url.startswith("https://"):
+        return "{cdn}/" + url[len("https://"):]
+    if url.startswith("http://"):
+        return "{cdn}/" + url[len("http://"):]
+    return url
+
+
+def rewrite_release(release):
+    if "artworks" in release:
+        release["artworks"] = [to_cdn(url) for url in release["artworks"]]
+    if "track_urls" in release:
+        release["track_urls"] = [to_cdn(url) for url in release["track_urls"]]
+    return release
+
+
+def synthesise_registry(stores):
+    rng = random.Random(config["seed"])
+    releases = {}
+    indices = []
+    for store, info in stores.items():
+        for section in info.get("sections", []):
+            for view in info.get("view_order", info.get("views", {}).keys()):
+                indices.append((store, f"{store}-{section}-{view}"))
+
+    for i in range(config["releases"]):
+        store, _ = indices[i % len(indices)] if len(indices) > 0 else ("standin", "")
+        key = f"{store}-si{i:05d}"
+        releases[key] = {
+            "id": f"si{i:05d}",
+            "store": store,
+            "link": f"https://standin.local/release/{i}",
+            "artist": f"Standin Artist {i}",
+            "title": f"Standin Title {i}",
+            "label": f"Standin Label {i % 17}",
+            "cat": f"SI{i:05d}",
+            "artworks": [f"https://cdn.standin.local/art/{i}-{size}.png" for size in ["s", "m", "l"]],
+            "track_names": [f"Track {t + 1}" for t in range(config["tracks"])],
+            "track_urls": [f"https://cdn.standin.local/audio/{i}-{t}.mp3" for t in range(config["tracks"])],
+            "store_tags": {},
+            "updated": int(time.time())
+        }
+
+    # each release charts in a few of its store's indices
+    for store, index in indices:
+        keys = [k for k, r in releases.items() if r["store"] == store]
+        rng.shuffle(keys)
+        for pos, key in enumerate(keys[:max(1, len(keys) // 2)]):
+            releases[key][index] = pos
+    return releases
+
+
+# a nightly scrape in miniature: some releases move position, some drop out of an index (which leaves
+# a stamped release without the index key, the tombstone clients look for) and some new ones chart
+def simulate_scrape(rng):
+    with lock:
+        releases = database["releases"]
+        indices = sorted({k for r in releases.values() for k in r.keys() if k.count("-") >= 2 and isinstance(r[k], int)})
+        if len(indices) == 0:
+            return
+        stamp = int(time.time())
+        keys = list(releases.keys())
+        moved = dropped = added = 0
+        for _ in range(config["churn"]):
+            release = releases[rng.choice(keys)]
+            charted = [index for index in indices if index in release]
+            action = rng.random()
+            if action < 0.5 and len(charted) > 0:
+                release[rng.choice(charted)] = rng.randrange(max(1, config["releases"] // 2))
+                moved += 1
+            elif action < 0.75 and len(charted) > 0:
+                del release[rng.choice(charted)]
+                dropped += 1
+            else:
+                release[rng.choice(indices)] = rng.randrange(max(1, config["releases"] // 2))
+                added += 1
+            release["updated"] = stamp
+        stats["scrapes"] += 1
+    print(f"simulated scrape: {moved} moved, {dropped} dropped, {added} added at {stamp}", flush=True)
+
+
+def scrape():
+    rng = random.Random(config["seed"] + 1)
+    while True:
+        time.sleep(config["scrape_interval"])
+        simulate_scrape(rng)
+
+
+def load_database():
+    fixtures = config["fixtures"]
+    stores = load_json(os.path.join(fixtures, "stores.json"))
+    if stores is None:
+        stores = load_json(os.path.join(os.path.dirname(__file__), "..", "..", "scrape", "stores.json")) or {}
+
+    releases = load_json(os.path.join(fixtures, "releases.json"))
+    if releases is None:
+        # merge recorded query responses
+        if os.path.isdir(fixtures):
+            for filename in sorted(os.listdir(fixtures)):
+                if filename.count("-") >= 2 and filename.endswith(".json"):
+                    recorded = load_json(os.path.join(fixtures, filename))
+                    if isinstance(recorded, dict):
+                        releases = releases or {}
+                        for key, release in recorded.items():
+                            releases.setdefault(key, {}).update(release)
+    if releases is None:
+        releases = synthesise_registry(stores)
+
+    for release in releases.values():
+        rewrite_release(release)
+        release.setdefault("updated", int(time.time()))
+
+    database["stores"] = stores
+    database["releases"] = releases
+    database["users"] = {}
+    database["likes"] = {}
+    print(f"serving {len(releases)} releases, {len(stores)} stores", flush=True)
+
+
+# value at a child path such as "likes/updated", None if it's missing
+def child(value, path):
+    for part in path.split("/"):
+        if not isinstance(value, dict) or part not in value:
+            return None
+        value = value[part]
+    return value
+
+
+# firebase server values, {".sv": "timestamp"} is the server time in milliseconds
+def server_values(value):
+    if isinstance(value, dict):
+        if value.get(".sv") == "timestamp":
+            return int(time.time() * 1000)
+        return {k: server_values(v) for k, v in value.items()}
+    return value
+
+
+# firebase rest query subset: orderBy a child path or $key, startAt / endAt / equalTo and limitToFirst / limitToLast
+def query(node, params):
+    if not isinstance(node, dict) or "orderBy" not in params:
+        return node
+
+    order_by = json.loads(params["orderBy"][0])
+    if order_by == "$key":
+        items = [(k, k, v) for k, v in node.items()]
+    else:
+        items = [(child(v, order_by), k, v) for k, v in node.items()]
+        items = [item for item in items if item[0] is not None]
+    items.sort(key=lambda item: (item[0], item[1]))
+
+    if "equalTo" in params:
+        value = json.loads(params["equalTo"][0])
+        items = [item for item in items if item[0] == value]
+    if "startAt" in params:
+        value = json.loads(params["startAt"][0])
+        items = [item for item in items if item[0] >= value]
+    if "endAt" in params:
+        value = json.loads(params["endAt"][0])
+        items = [item for item in items if item[0] <= value]
+    if "limitToFirst" in params:
+        items = items[:int(params["limitToFirst"][0])]
+    if "limitToLast" in params:
+        items = items[-int(params["limitToLast"][0]):]
+    return {k: v for _, k, v in items}
+
+
+def resolve(path, create=False):
+    node = database
+    parts = [p for p in path.split("/") if p]
+    for i, part in enumerate(parts):
+        if not isinstance(node, dict):
+            return None, None, None
+        if part not in node:
+            if not create:
+                return None, None, None
+            node[part] = {}
+        if i == len(parts) - 1:
+            return node, part, node[part]
+        node = node[part]
+    return None, None, database
+
+
+def substitute_cdn(value, cdn):
+    text = json.dumps(value)
+    return text.replace("{cdn}", cdn)
+
+
+def png(width, height, seed):
+    rng = random.Random(seed)
+    r, g, b = rng.randrange(256), rng.randrange(256), rng.randrange(256)
+    row = b"\x00" + bytes([r, g, b]) * width
+    raw = row * height
+
+    def chunk(tag, data):
+        body = tag + data
+        return struct.pack(">I", len(data)) + body + struct.pack(">I", zlib.crc32(body) & 0xffffffff)
+
+    header = struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)
+    return b"\x89PNG\r\n\x1a\n" + chunk(b"IHDR", header) + chunk(b"IDAT", zlib.compress(raw)) + chunk(b"IEND", b"")
+
+
+# mpeg-1 layer iii frames at 128kbps 44.1khz with zeroed side info, which decode to silence
+def silent_mp3(seconds):
+    frame = b"\xff\xfb\x90\x64" + b"\x00" * 413
+    return frame * int(seconds * 44100 / 1152)
+
+
+def cdn_asset(path):
+    recorded = os.path.join(config["fixtures"], "cdn", path)
+    if os.path.isfile(recorded):
+        with open(recorded, "rb") as f:
+            return f.read()
+    seed = zlib.crc32(path.encode("utf-8"))
+    if path.endswith(".mp3"):
+        return silent_mp3(30)
+    return png(256, 256, seed)
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    # headers and body go out in separate writes, with nagle on each response waits out a delayed ack
+    disable_nagle_algorithm = True
+
+    def log_message(self, format, *args):
+        pass
+
+    def send_body(self, code, body, content_type, extra_headers={}):
+        injected_error = random.random() < config["error_rate"]
+        if injected_error:
+            code, body, content_type = 500, b'{"error": "injected"}', "application/json"
+            stats["errors"] += 1
+
+        encoding = None
+        if content_type == "application/json" and "gzip" in self.headers.get("Accept-Encoding", ""):
+            body = gzip.compress(body)
+            encoding = "gzip"
+
+        self.send_response(code)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        if encoding:
+            self.send_header("Content-Encoding", encoding)
+        for key, value in extra_headers.items():
+            self.send_header(key, value)
+        self.end_headers()
+
+        if self.command == "HEAD":
+            return
+
+        # drop the connection part way through to exercise partial downloads
+        if not injected_error and len(body) > 1 and random.random() < config["drop_rate"]:
+            stats["drops"] += 1
+            self.write_throttled(body[:len(body) // 2])
+            self.close_connection = True
+            return
+
+        self.write_throttled(body)
+
+    def write_throttled(self, body):
+        if config["bandwidth"] <= 0:
+            self.wfile.write(body)
+            return
+        chunk_size = 16 * 1024
+        for i in range(0, len(body), chunk_size):
+            chunk = body[i:i + chunk_size]
+            self.wfile.write(chunk)
+            time.sleep(len(chunk) / config["bandwidth"])
+
+    def send_json(self, value, cdn):
+        body = substitute_cdn(value, cdn).encode("utf-8")
+        etag = '"' + hashlib.md5(body).hexdigest() + '"'
+        if self.headers.get("If-None-Match") == etag:
+            self.send_response(304)
+            self.send_header("ETag", etag)
+            self.send_header("Content-Length", "0")
+            self.end_headers()
+            return
+        self.send_body(200, body, "application/json", {"ETag": etag})
+
+    def read_body(self):
+        length = int(self.headers.get("Content-Length", 0))
+        if length <= 0:
+            return None
+        return json.loads(self.rfile.read(length))
+
+    def handle_cdn(self, path):
+        time.sleep(config["cdn_latency"])
+        stats["cdn"] += 1
+        data = cdn_asset(path)
+        content_type = "audio/mpeg" if path.endswith(".mp3") else "image/png"
+
+        # byte ranges, for resumed downloads
+        range_header = self.headers.get("Range", "")
+        if range_header.startswith("bytes="):
+            start = int(range_header[len("bytes="):].split("-")[0] or 0)
+            if start >= len(data):
+                self.send_body(416, b"", content_type, {"Content-Range": f"bytes */{len(data)}"})
+                return
+            self.send_body(206, data[start:], content_type, {
+                "Content-Range": f"bytes {start}-{len(data) - 1}/{len(data)}",
+                "Accept-Ranges": "bytes"
+            })
+            return
+        self.send_body(200, data, content_type, {"Accept-Ranges": "bytes"})
+
+    def handle_identity(self, path):
+        time.sleep(config["latency"])
+        stats["auth"] += 1
+        body = self.read_body() or {}
+        email = body.get("email", "standin@standin.local") if isinstance(body, dict) else "standin@standin.local"
+        self.send_json({
+            "localId": "standin-user",
+            "email": email,
+            "idToken": "standin-token",
+            "refreshToken": "standin-refresh",
+            "expiresIn": "3600",
+            "registered": True
+        }, "")
+
+    def handle_database(self, path, params):
+        time.sleep(config["latency"])
+        stats["database"] += 1
+        cdn = f"{scheme()}://{self.headers.get('Host')}/cdn"
+        if not path.endswith(".json"):
+            self.send_json({"error": "404 Not Found"}, cdn)
+            return
+        path = path[:-len(".json")]
+
+        if params.get("orderBy") in [['"updated"'], ['"likes/updated"']]:
+            stats["delta"] += 1
+
+        with lock:
+            if self.command in ["GET", "HEAD"]:
+                _, _, node = resolve(path)
+                value = copy.deepcopy(query(node, params))
+            elif self.command == "PUT":
+                parent, key, _ = resolve(path, create=True)
+                value = server_values(self.read_body())
+                if parent is not None:
+                    parent[key] = value
+            elif self.command == "PATCH":
+                parent, key, node = resolve(path, create=True)
+                value = server_values(self.read_body() or {})
+                if isinstance(node, dict):
+                    node.update(value)
+                    value = copy.deepcopy(node)
+            elif self.command == "DELETE":
+                parent, key, _ = resolve(path)
+                if parent is not None:
+                    del parent[key]
+                value = None
+            else:
+                value = None
+
+        self.send_json(value, cdn)
+
+    def route(self):
+        url = urlparse(self.path)
+        path = unquote(url.path)
+        if path.startswith("/cdn/"):
+            self.handle_cdn(path[len("/cdn/"):])
+        elif path.startswith("/v1/accounts"):
+            self.handle_identity(path)
+        else:
+            self.handle_database(path, parse_qs(url.query))
+
+    def do_GET(self):
+        self.route()
+
+    def do_HEAD(self):
+        self.route()
+
+    def do_PUT(self):
+        self.route()
+
+    def do_PATCH(self):
+        self.route()
+
+    def do_POST(self):
+        self.route()
+
+    def do_DELETE(self):
+        self.route()
+
+
+def scheme():
+    return "https" if config["cert"] else "http"
+
+
+def report():
+    while True:
+        time.sleep(10.0)
+        print(" ".join(f"{k}: {v}" for k, v in sorted(stats.items())), flush=True)
+
+
+if __name__ == "__main__":
+    parse_args()
+    random.seed(config["seed"])
+    load_database()
+    threading.Thread(target=report, daemon=True).start()
+    if config["scrape_interval"] > 0:
+        threading.Thread(target=scrape, daemon=True).start()
+    server = ThreadingHTTPServer(("", config["port"]), Handler)
+    if config["cert"]:
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(config["cert"], config["key"] or None)
+        server.socket = context.wrap_socket(server.socket, server_side=True)
+    print(f"firebase stand-in on {scheme()}://localhost:{config['port']}", flush=True)
+    server.serve_forever()
@@ -418,6 +418,12 @@ def update_stores():
                     release_indexes.append(index)
                     print(f"added new search index: {index}")
 
+    # delta sync queries order by the scrape stamp and the like stamp the client writes with like counts
+    for index in ["updated", "likes/updated"]:
+        if index not in release_indexes:
+            release_indexes.append(index)
+            print(f"added new search index: {index}")
+
     # patch rules
     rules_str = json.dumps(rules, indent=4)
     response = authed_session.put(
@@ -431,6 +437,30 @@ def update_stores():
 
 
 
+# the "updated" key stamps releases with the unix time of the scrape that changed them. clients keep a
+# full copy of each index and only ask for releases stamped since their last sync (orderBy "updated").
+# a stamped release which no longer carries an index key is a tombstone for that index: it fell out of
+# the view when the trackers were cleared and wasn't re-scraped into it
+def stamp_release(release, timestamp=None):
+    release["updated"] = int(timestamp if timestamp else time.time())
+
+
+# stamps every release in after which is new or differs from before, ignoring the stamp itself
+def stamp_updated(before, after):
+    timestamp = int(time.time())
+    stamped = 0
+    for key, release in after.items():
+        prev = before.get(key)
+        if prev is not None:
+            prev = {k: v for k, v in prev.items() if k != "updated"}
+            cur = {k: v for k, v in release.items() if k != "updated"}
+            if prev == cur and "updated" in release:
+                continue
+        stamp_release(release, timestamp)
+        stamped += 1
+    print(f"stamped {stamped} updated releases")
+
+
 # clears the chart position and section position tracker, that will be re-populated during the next scrape
 # allows old items to fall out of a view
 def clear_tracker_keys(store, view_tracker_keys):
@@ -461,6 +491,7 @@ def patch_store(store):
 # patch store releases
 def fix_store(store):
     releases = load_registry(store)
+    before = json.loads(json.dumps(releases))
     for release in releases:
         # custom code for juno artwork fix
         update_artwork = list()
@@ -473,6 +504,7 @@ def fix_store(store):
         patch_single_str = json.dumps(releases[release], indent=4)
         if "-verbose" in sys.argv:
             print(patch_single_str)
+    stamp_updated(before, releases)
     write_registry(store, releases)
     patch_releases(releases, throw_assert=True)
 
@@ -680,8 +712,12 @@ if __name__ == '__main__':
         # store name
         store = sys.argv[sys.argv.index("-store") + 1]
         if not "-patch-only" in sys.argv:
-            # scrape
+            # scrape, then stamp whatever the scrape changed for delta syncing clients
+            before = load_registry(store)
             scrape_store(stores, store)
+            releases = load_registry(store)
+            stamp_updated(before, releases)
+            write_registry(store, releases)
         # patch (skip if local-only)
         if not local_only:
             patch_store(store)
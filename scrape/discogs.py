@@ -576,6 +576,7 @@ def skip_invalid_entry(key, release):
 
 def populate_discogs_links(discogs, store):
     reg = dig.load_registry(store)
+    before = json.loads(json.dumps(reg))
 
     count = 0
     hits = 0
@@ -713,7 +714,8 @@ def populate_discogs_links(discogs, store):
 
     print(f"Job complete: {count} new additions, {hits} have info / {len(reg)}, {prev_attemps} previously attempted ({preorders} preorders), {failures} failures, format check: {format_verified} verified vinyl, {format_switched} switched to master")
     
-    # write to file
+    # write to file, stamping the releases which changed for delta syncing clients
+    dig.stamp_updated(before, reg)
     dig.write_registry(store, reg)
     dig.patch_releases(reg)
 
@@ -725,6 +727,7 @@ def populate_discogs_likes(discogs, likes_file):
         if file.endswith(".json"):
             reg_file = f"diig-registry/{file}"
             reg = json.loads(open(reg_file, "r").read())
+            before = json.loads(json.dumps(reg))
             for entry in likes:
                 if entry in reg:
                     if skip_invalid_entry(entry, reg[entry]):
@@ -751,6 +754,7 @@ def populate_discogs_likes(discogs, likes_file):
                         print(f"{entry} {reg[entry].get('cat', '')} - previously attempted and failed to find")
                     else:
                         print(f"{entry} {reg[entry].get('cat', '')} - already exists")
+            dig.stamp_updated(before, reg)
             open(reg_file, "w").write(json.dumps(reg, indent=4))
             dig.patch_releases(reg)
 
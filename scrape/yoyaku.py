@@ -444,6 +444,7 @@ def backfill_missing():
             print(f"  skipping malformed entry: {issues}", flush=True)
             continue
 
+        dig.stamp_release(release)
         releases_dict[key] = release
         updated[key] = release
         print(